@@ -10,7 +10,9 @@
 
 #include "animation.h"
 #include "GameObject.h"
+#include "T3DApplication.h"
 #include "Math.h"
+#include "Simd.h"
 
 namespace T3D
 {
@@ -19,53 +21,232 @@ namespace T3D
 		time = 0;
 		looping = false;
 		playing = false;
+		binding = NULL;
+		clip = NULL;
 	}
 
 
 	Animation::~Animation(void)
 	{
+		for (unsigned int i = 0; i < boneList.size(); ++i)
+			delete boneList[i];
+		if (binding) binding->release();
+		if (clip) clip->release();
+	}
+
+	void Animation::setBinding(AnimationBinding *b)
+	{
+		if (b) b->addRef();
+		if (binding) binding->release();
+		binding = b;
+
+		// resolved by addBone if the animation isn't attached yet
+		transforms.clear();
+		if (binding && gameObject) binding->resolve(gameObject->getTransform(), transforms);
+	}
+
+	void Animation::setClip(CompressedClip *c)
+	{
+		if (c) c->addRef();
+		if (clip) clip->release();
+		clip = c;
+
+		if (clip){
+			duration = clip->getDuration();
+			setBinding(clip->getBinding());
+		}
 	}
 
 	void Animation::addKey(std::string n, float time, Quaternion rot, Vector3 pos){
+		Bone *b = findOrAddBone(n);
+		if (b == NULL) return;
+
+		KeyFrame f = {time,rot,pos};
+		b->addFrame(f);
+	}
+
+	void Animation::addKeys(std::string n, const KeyFrame *frames, int count){
+		Bone *b = findOrAddBone(n);
+		if (b == NULL) return;
+
+		b->addFrames(frames,count);
+	}
+
+	// NULL if there is no transform called n, addBone reports the error
+	Bone* Animation::findOrAddBone(std::string n){
 		BoneMap::iterator it = bones.find(n);
 
 		if(it == bones.end())
 		{
 		   addBone(n);
+		   it = bones.find(n);
+		   if (it == bones.end()) return NULL;
 		}
-
-		KeyFrame f = {time,rot,pos};
-		bones[n]->addFrame(f);
+		return it->second;
 	}
 
 	void Animation::addBone(std::string n)
 	{
-		Bone *b = new Bone();
-		b->transform = gameObject->getTransform()->getAncestorByName(n);
-		if (b->transform!=NULL){
+		if (binding == NULL)
+			setBinding(new AnimationBinding(gameObject->getTransform()));
+		else if ((int)transforms.size() != binding->getBoneCount())
+			binding->resolve(gameObject->getTransform(), transforms);
+
+		int index = binding->findBone(n);
+		Transform *t = index < 0 ? NULL : transforms[index];
+		if (t!=NULL){
+			Bone *b = new Bone();
+			b->transform = t;
 			bones.insert(BoneEntry(n,b));
+			boneList.push_back(b);
 		} else {
-			std::cout << "ERROR: bone not found in addBone(" << n << ")\n)";
+			std::cout << "ERROR: bone not found in addBone(" << n << ")\n";
 		}
 	}
 
 	void Animation::update(float dt){		
-		if (playing){
-			time += dt;
-			if (time>duration){
-				if (looping){
-					while (time>duration)
-						time = time-duration;
-				} else {
-					time = duration;
-					playing = false;
+		Component *self = this;
+		updateAll(&self, 1, dt);
+	}
+
+	// steps the clock, true if the bones should be posed this update
+	bool Animation::advance(float dt){
+		if (!playing) return false;
+
+		time += dt;
+		if (time>duration){
+			if (looping){
+				while (time>duration)
+					time = time-duration;
+			} else {
+				time = duration;
+				playing = false;			// posed at the end one last time
+			}
+		}
+		return true;
+	}
+
+	void Animation::updateAll(Component** components, int count, float dt){
+		JobSystem *jobs = NULL;
+		Animation **posed = NULL;
+		int posedCount = 0;
+		int total = 0;
+
+		for (int i = 0; i < count; ++i){
+			Animation *a = (Animation*)components[i];
+			if (a == NULL || !a->advance(dt)) continue;
+
+			if (posed == NULL){
+				jobs = a->gameObject->getApp()->getJobSystem();
+				posed = jobs->getScratch(jobs->getCurrentWorker()).allocate<Animation*>(count - i);
+			}
+			posed[posedCount++] = a;
+			total += a->clip ? a->clip->getTrackCount() : (int)a->boneList.size();
+		}
+		if (total == 0) return;
+
+		// pose buffers, blending from keyframe a to keyframe b, with the result written over a
+		ScratchAllocator &scratch = jobs->getScratch(jobs->getCurrentWorker());
+		float *buffer = scratch.allocate<float>(total * 15);
+		float *ax = buffer, *ay = ax + total, *az = ay + total;
+		float *bx = az + total, *by = bx + total, *bz = by + total;
+		float *as = bz + total, *aqx = as + total, *aqy = aqx + total, *aqz = aqy + total;
+		float *bs = aqz + total, *bqx = bs + total, *bqy = bqx + total, *bqz = bqy + total;
+		float *t = bqz + total;
+		Transform **targets = scratch.allocate<Transform*>(total);
+
+		int n = 0;
+		for (int i = 0; i < posedCount; ++i){
+			Animation *anim = posed[i];
+			if (anim->clip){
+				// evenly spaced frames, so one index for every bone
+				CompressedClip *c = anim->clip;
+				if ((int)anim->transforms.size() != anim->binding->getBoneCount())
+					anim->binding->resolve(anim->gameObject->getTransform(), anim->transforms);
+				int frame;
+				float alpha;
+				c->getFrame(anim->time, frame, alpha);
+				CompressedClip::Pose a = { ax, ay, az, as, aqx, aqy, aqz };
+				CompressedClip::Pose b = { bx, by, bz, bs, bqx, bqy, bqz };
+				c->decodeFrame(frame, a, n);
+				c->decodeFrame(alpha > 0 ? frame + 1 : frame, b, n);
+				for (int j = 0; j < c->getTrackCount(); ++j, ++n){
+					targets[n] = anim->transforms[c->getTrackBone(j)];
+					t[n] = alpha;
 				}
+				continue;
 			}
-			BoneMap::iterator it;
-			for (it = bones.begin(); it!= bones.end(); it++){
-				Bone *b = it->second;
-				b->update(time);
+			for (unsigned int j = 0; j < anim->boneList.size(); ++j, ++n){
+				Bone *bone = anim->boneList[j];
+				int from, to;
+				if (!bone->getSegment(anim->time, from, to, t[n])){
+					targets[n] = NULL;			// no keyframes, blend something harmless
+					t[n] = 0;
+					ax[n] = ay[n] = az[n] = bx[n] = by[n] = bz[n] = 0;
+					as[n] = bs[n] = 1;
+					aqx[n] = aqy[n] = aqz[n] = bqx[n] = bqy[n] = bqz[n] = 0;
+					continue;
+				}
+				targets[n] = bone->transform;
+				const KeyFrame &ka = bone->keyframes[from];
+				const KeyFrame &kb = bone->keyframes[to];
+				ax[n] = ka.position.x; ay[n] = ka.position.y; az[n] = ka.position.z;
+				bx[n] = kb.position.x; by[n] = kb.position.y; bz[n] = kb.position.z;
+				as[n] = ka.rotation.s; aqx[n] = ka.rotation.v.x; aqy[n] = ka.rotation.v.y; aqz[n] = ka.rotation.v.z;
+				bs[n] = kb.rotation.s; bqx[n] = kb.rotation.v.x; bqy[n] = kb.rotation.v.y; bqz[n] = kb.rotation.v.z;
 			}
 		}
+
+		int i = 0;
+#ifdef T3D_SSE
+		__m128 signBit = _mm_set1_ps(-0.0f);
+		for (; i + 4 <= total; i += 4){
+			__m128 vt = _mm_loadu_ps(t+i);
+
+			__m128 px = _mm_loadu_ps(ax+i), py = _mm_loadu_ps(ay+i), pz = _mm_loadu_ps(az+i);
+			_mm_storeu_ps(ax+i, _mm_add_ps(px, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bx+i), px), vt)));
+			_mm_storeu_ps(ay+i, _mm_add_ps(py, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(by+i), py), vt)));
+			_mm_storeu_ps(az+i, _mm_add_ps(pz, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bz+i), pz), vt)));
+
+			__m128 qas = _mm_loadu_ps(as+i), qax = _mm_loadu_ps(aqx+i), qay = _mm_loadu_ps(aqy+i), qaz = _mm_loadu_ps(aqz+i);
+			__m128 qbs = _mm_loadu_ps(bs+i), qbx = _mm_loadu_ps(bqx+i), qby = _mm_loadu_ps(bqy+i), qbz = _mm_loadu_ps(bqz+i);
+
+			// take the short way round, flipping b where the dot product is negative
+			__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qas, qbs), _mm_mul_ps(qax, qbx)),
+				_mm_add_ps(_mm_mul_ps(qay, qby), _mm_mul_ps(qaz, qbz)));
+			__m128 flip = _mm_and_ps(dot, signBit);
+			qbs = _mm_xor_ps(qbs, flip); qbx = _mm_xor_ps(qbx, flip);
+			qby = _mm_xor_ps(qby, flip); qbz = _mm_xor_ps(qbz, flip);
+
+			__m128 qs = _mm_add_ps(qas, _mm_mul_ps(_mm_sub_ps(qbs, qas), vt));
+			__m128 qx = _mm_add_ps(qax, _mm_mul_ps(_mm_sub_ps(qbx, qax), vt));
+			__m128 qy = _mm_add_ps(qay, _mm_mul_ps(_mm_sub_ps(qby, qay), vt));
+			__m128 qz = _mm_add_ps(qaz, _mm_mul_ps(_mm_sub_ps(qbz, qaz), vt));
+
+			__m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(qs, qs), _mm_mul_ps(qx, qx)),
+				_mm_add_ps(_mm_mul_ps(qy, qy), _mm_mul_ps(qz, qz))));
+			_mm_storeu_ps(as+i, _mm_div_ps(qs, len));
+			_mm_storeu_ps(aqx+i, _mm_div_ps(qx, len));
+			_mm_storeu_ps(aqy+i, _mm_div_ps(qy, len));
+			_mm_storeu_ps(aqz+i, _mm_div_ps(qz, len));
+		}
+#endif
+		for (; i < total; ++i){
+			ax[i] = Math::lerp(ax[i], bx[i], t[i]);
+			ay[i] = Math::lerp(ay[i], by[i], t[i]);
+			az[i] = Math::lerp(az[i], bz[i], t[i]);
+
+			Quaternion qa(as[i], aqx[i], aqy[i], aqz[i]);
+			Quaternion qb(bs[i], bqx[i], bqy[i], bqz[i]);
+			if (Quaternion::dot(qa, qb) < 0) qb = -qb;
+			Quaternion q = Quaternion::lerp(qa, qb, t[i]);
+			as[i] = q.s; aqx[i] = q.v.x; aqy[i] = q.v.y; aqz[i] = q.v.z;
+		}
+
+		// one world update per bone
+		for (i = 0; i < total; ++i){
+			if (targets[i] != NULL)
+				targets[i]->setLocalPositionRotation(Vector3(ax[i], ay[i], az[i]), Quaternion(as[i], aqx[i], aqy[i], aqz[i]));
+		}
 	}
 }
@@ -20,6 +20,8 @@
 #include "Transform.h"
 #include "Vector3.h"
 #include "Bone.h"
+#include "AnimationBinding.h"
+#include "CompressedClip.h"
 
 namespace T3D
 {
@@ -35,8 +37,33 @@ namespace T3D
 		
 		virtual void update(float dt);
 
+		/*! Poses the bones of a batch of animations together
+		  Every playing animation is sampled into one set of structure of arrays pose buffers,
+		  blended four bones at a time, then each bone's Transform is written once.  Rotations are
+		  normalised lerps rather than the slerp Bone::update uses.
+		  */
+		virtual void updateAll(Component** components, int count, float dt);
+		virtual UpdateAccess getUpdateAccess() const { return ACCESS_OWN_TRANSFORM; }
+
+		/*! Shares bone lookups with other instances of the same skeleton
+		  Call before adding keys.  Without this the first addBone creates a binding for the
+		  animation's own skeleton, which getBinding returns for other instances to share.
+		  \param b		binding made from a skeleton with the same hierarchy as this one
+		  */
+		void setBinding(AnimationBinding *b);
+		AnimationBinding* getBinding(){ return binding; }
+
+		/*! Plays a compressed clip instead of the animation's own keyframes
+		  Takes the clip's binding and duration.  Clips can be shared by any number of animations.
+		  \param c		clip to play, NULL to go back to the keyframes
+		  */
+		void setClip(CompressedClip *c);
+		CompressedClip* getClip(){ return clip; }
+
 		void addBone(std::string n);
 		void addKey(std::string n, float time, Quaternion rot, Vector3 pos);
+		//! Adds a whole clip's keyframes for one bone, much faster than addKey for long clips
+		void addKeys(std::string n, const KeyFrame *frames, int count);
 
 		void play(){ time = 0; playing = true; }
 		void pause(){ playing = false; }
@@ -65,7 +92,16 @@ namespace T3D
         }
 
 	protected:
+		friend class CompressedClip;
+
+		Bone* findOrAddBone(std::string n);
+		bool advance(float dt);
+
 		BoneMap bones;
+		std::vector<Bone*> boneList;		// bones in the order added, for update
+		AnimationBinding *binding;
+		CompressedClip *clip;
+		std::vector<Transform*> transforms;	// this instance's transform for each binding index
 		float duration;
 		int frames;
 
@@ -0,0 +1,63 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming
+// =========================================================================================
+//
+// AnimationBinding.cpp
+//
+// Bone names resolved against a skeleton once, shared by every instance of that skeleton
+// Each named transform is recorded by its parent and child position rather than its name, so
+// another copy of the skeleton is bound by walking child lists, with no string compares.
+
+#include "AnimationBinding.h"
+#include "Transform.h"
+
+namespace T3D
+{
+	AnimationBinding::AnimationBinding(Transform *skeleton)
+	{
+		if (skeleton == NULL) return;
+
+		std::vector<Transform*> queue;
+		queue.push_back(skeleton);
+		parents.push_back(-1);
+		childIndices.push_back(0);
+
+		for (unsigned int i = 0; i < queue.size(); ++i)
+		{
+			Transform *t = queue[i];
+			names.insert(std::make_pair(t->name, (int)i));		// keeps the first, nearest the root
+
+			for (unsigned int c = 0; c < t->children.size(); ++c)
+			{
+				if (t->children[c] == NULL) continue;
+				queue.push_back(t->children[c]);
+				parents.push_back((int)i);
+				childIndices.push_back((int)c);
+			}
+		}
+	}
+
+	AnimationBinding::~AnimationBinding(void)
+	{
+	}
+
+	int AnimationBinding::findBone(const std::string &name) const
+	{
+		std::map<std::string, int>::const_iterator it = names.find(name);
+		return it == names.end() ? -1 : it->second;
+	}
+
+	void AnimationBinding::resolve(Transform *skeleton, std::vector<Transform*> &transforms) const
+	{
+		transforms.resize(parents.size());
+		if (transforms.empty()) return;
+
+		transforms[0] = skeleton;
+		for (unsigned int i = 1; i < parents.size(); ++i)
+		{
+			Transform *parent = transforms[parents[i]];
+			unsigned int c = (unsigned int)childIndices[i];
+			transforms[i] = (parent != NULL && c < parent->children.size()) ? parent->children[c] : NULL;
+		}
+	}
+}
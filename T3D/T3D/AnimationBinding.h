@@ -0,0 +1,55 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming
+// =========================================================================================
+//
+// AnimationBinding.h
+//
+// Bone names resolved against a skeleton once, shared by every instance of that skeleton
+// Each named transform is recorded by its parent and child position rather than its name, so
+// another copy of the skeleton is bound by walking child lists, with no string compares.
+
+#ifndef ANIMATIONBINDING_H
+#define ANIMATIONBINDING_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include "RefCounted.h"
+
+namespace T3D
+{
+	class Transform;
+
+	//! Shared between instances of a skeleton, Animation::setBinding takes a reference and the animation's destructor releases it
+	class AnimationBinding : public RefCounted
+	{
+	public:
+		/*! Records every transform in the skeleton, searching it once breadth first
+		  \param skeleton	root of the skeleton, normally the animated game object's transform
+		  */
+		AnimationBinding(Transform *skeleton);
+		virtual ~AnimationBinding(void);
+
+		int getBoneCount() const { return (int)parents.size(); }
+
+		/*! Index of a bone, the nearest transform with the name as getAncestorByName would find
+		  \return	-1 if there is no transform with that name
+		  */
+		int findBone(const std::string &name) const;
+
+		/*! Finds each bone in an instance of the skeleton
+		  Bones missing from the instance, because its hierarchy differs, are NULL.
+		  \param skeleton		root of the instance
+		  \param transforms	receives getBoneCount() transforms, indexed as findBone
+		  */
+		void resolve(Transform *skeleton, std::vector<Transform*> &transforms) const;
+
+	private:
+		// in breadth first order, so a bone's parent always comes before it
+		std::vector<int> parents;			// index of the parent bone, -1 for the skeleton root
+		std::vector<int> childIndices;		// position in the parent's children
+		std::map<std::string, int> names;	// first bone with each name
+	};
+}
+
+#endif
@@ -0,0 +1,415 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// benchmarkapplication.cpp
+//
+// Headless application that builds a parameterised test scene, runs it for a fixed number
+// of frames at a fixed time step and reports the time spent in each phase as JSON.
+
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <iomanip>
+
+#include "BenchmarkApplication.h"
+#include "Profiler.h"
+#include "Camera.h"
+#include "Light.h"
+#include "Math.h"
+#include "RotateBehaviour.h"
+#include "ParticleEmitter.h"
+#include "ParticleSystem.h"
+#include "Animation.h"
+#include "Terrain.h"
+#include "TerrainFollower.h"
+
+namespace T3D
+{
+	static const int CHAIN_LENGTH = 50;				// links per chain in the chain scene
+	static const int EMITTER_PARTICLES = 1000;		// particles per emitter in the particle scene
+	static const int SYSTEM_PARTICLES = 10000;		// particles per system in the particle system scene
+	static const int CHARACTER_BONES = 16;			// bones per character in the animation scene
+	static const int TERRAIN_FOLLOWERS = 256;		// objects following the terrain in the terrain scene
+	static const int DEBRIS_RESOLUTION = 128;		// terrain grid cells per side in the debris scene
+	static const int EFFECT_PARTICLES = 2000;		// particles per system in the effects scene
+
+	BenchmarkApplication::BenchmarkApplication(std::string scene, int count, int frames, int workers, bool flat) :
+		HeadlessApplication(frames)
+	{
+		this->scene = scene;
+		this->count = count;
+		this->workers = workers;
+		this->flat = flat;
+		extent = 5;
+		red = NULL;
+	}
+
+	BenchmarkApplication::~BenchmarkApplication(void)
+	{
+	}
+
+	bool BenchmarkApplication::init(){
+		// same scene every run so results can be compared between builds
+		srand(1);
+
+		setWorkerCount(workers);
+
+		// spread objects out at about the density of Tutorial1_Baseline
+		extent = std::max(5.0f, 0.75f * (float)pow((double)count, 1.0/3.0));
+
+		//Create a camera looking at the scene from outside so that some of it is culled
+		GameObject *camObj = new GameObject(this);
+		renderer->camera = new Camera(Camera::PERSPECTIVE, 0.1, 4.0 * extent, 45.0, 1.6);
+		camObj->getTransform()->setLocalPosition(Vector3(0, 0, 2 * extent));
+		camObj->getTransform()->setLocalRotation(Vector3(0, 0, 0));
+		camObj->setCamera(renderer->camera);
+		camObj->getTransform()->setParent(root);
+
+		//Add a light
+		GameObject *lightObj = new GameObject(this);
+		Light *light = new Light(Light::DIRECTIONAL);
+		light->setAmbient(1, 1, 1);
+		light->setDiffuse(1, 1, 1);
+		light->setSpecular(1, 1, 1);
+		lightObj->setLight(light);
+		lightObj->getTransform()->setLocalRotation(
+			Vector3(-45 * Math::DEG2RAD, 70 * Math::DEG2RAD, 0));
+		lightObj->getTransform()->setParent(root);
+
+		red = renderer->createMaterial(Renderer::PR_OPAQUE);
+		red->setDiffuse(1, 0, 0, 1);
+
+		if (scene == "spheres") createSpheres();
+		else if (scene == "chain") createChains();
+		else if (scene == "particles") createParticles();
+		else if (scene == "particlesystem") createParticleSystems();
+		else if (scene == "animation") createAnimation(false);
+		else if (scene == "animationclip") createAnimation(true);
+		else if (scene == "terrain") createTerrain();
+		else if (scene == "debris") createDebris();
+		else if (scene == "effects") createEffects();
+		else {
+			std::cout << "ERROR: unknown benchmark scene " << scene << " (expected one of: " << getSceneNames() << ")\n";
+			return false;
+		}
+
+		setFlatHierarchy(flat);
+
+		// only time the frames, not the scene setup
+		Profiler::reset();
+		Profiler::enable(true);
+
+		return true;
+	}
+
+	void BenchmarkApplication::updateWorldMatrices(){
+		if (getHierarchy() != NULL)
+			HeadlessApplication::updateWorldMatrices();
+		else
+			refreshWorldMatrices();
+	}
+
+	int BenchmarkApplication::run(void){
+		int result = HeadlessApplication::run();
+		Profiler::enable(false);
+		return result;
+	}
+
+	//! N spheres at random positions, as in Tutorial1_Baseline
+	void BenchmarkApplication::createSpheres(){
+		for (int i = 0; i < count; i++) {
+			Vector3 point(
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent));
+
+			GameObject *sphere = new GameObject(this);
+			sphere->setMesh(meshCache->getSphere(0.5, 8));
+			sphere->setMaterial(red);
+			sphere->getTransform()->setLocalPosition(point);
+			sphere->getTransform()->setParent(root);
+			sphere->getTransform()->name = "Sphere";
+		}
+	}
+
+	//! Deep parent/child chains, every link rotating so that all world matrices change each frame
+	void BenchmarkApplication::createChains(){
+		int chains = (count + CHAIN_LENGTH - 1) / CHAIN_LENGTH;
+		int created = 0;
+
+		for (int c = 0; c < chains; c++) {
+			Transform *parent = root;
+			Vector3 offset(
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent));
+
+			for (int i = 0; i < CHAIN_LENGTH && created < count; i++, created++) {
+				GameObject *link = new GameObject(this);
+				link->setMesh(meshCache->getSphere(0.25, 8));
+				link->setMaterial(red);
+				link->addComponent(new RotateBehaviour(Vector3(0, 0.5f, 0.1f)));
+				link->getTransform()->setLocalPosition(offset);
+				link->getTransform()->setParent(parent);
+				link->getTransform()->name = "Link";
+
+				parent = link->getTransform();
+				offset = Vector3(0, 0.5f, 0);
+			}
+		}
+	}
+
+	//! Emitters of billboard particles running continuously
+	void BenchmarkApplication::createParticles(){
+		Material *sparkle = renderer->createMaterial(Renderer::PR_TRANSPARENT);
+		sparkle->setDiffuse(1, 1, 0.5f, 1);
+		sparkle->setBlending(Material::BLEND_ADD);
+		sparkle->setSortedDraw(true, true);
+
+		int emitters = (count + EMITTER_PARTICLES - 1) / EMITTER_PARTICLES;
+		for (int e = 0; e < emitters; e++) {
+			int n = std::min(EMITTER_PARTICLES, count - e * EMITTER_PARTICLES);
+			float rate = n / 1.5f;			// replaces particles as fast as they expire
+
+			GameObject *emitterObj = new GameObject(this);
+			emitterObj->getTransform()->setLocalPosition(Vector3(
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent)));
+			emitterObj->getTransform()->setParent(root);
+			emitterObj->getTransform()->name = "Emitter";
+
+			ParticleEmitter *emitter = new ParticleEmitter(0.0f, rate, 1000000.0f, rate, 0.0f, rate, 0.2f);
+			emitterObj->addComponent(emitter);
+			emitter->createBillboardParticles(n, 1.0f, 2.0f, sparkle, 0.2f, root);
+			emitter->setPositionRange(0.1f, 0.1f, 0.1f);
+			emitter->setDirection(0, 0, 180 * Math::DEG2RAD);
+			emitter->setStartVelocity(2.0f, 5.0f);
+			emitter->setAcceleration(-2.0f, 1.0f);
+			emitter->setAlphaFade(1.0f, 0.0f);
+			emitter->emit(n / 2);
+		}
+	}
+
+	//! As the particle scene, but with array based particle systems
+	void BenchmarkApplication::createParticleSystems(){
+		Material *sparkle = renderer->createMaterial(Renderer::PR_TRANSPARENT);
+		sparkle->setDiffuse(1, 1, 0.5f, 1);
+		sparkle->setBlending(Material::BLEND_ADD);
+		sparkle->setSortedDraw(true, true);
+
+		int systems = (count + SYSTEM_PARTICLES - 1) / SYSTEM_PARTICLES;
+		for (int e = 0; e < systems; e++) {
+			int n = std::min(SYSTEM_PARTICLES, count - e * SYSTEM_PARTICLES);
+			float rate = n / 1.5f;			// replaces particles as fast as they expire
+
+			GameObject *emitterObj = new GameObject(this);
+			emitterObj->getTransform()->setLocalPosition(Vector3(
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent)));
+			emitterObj->getTransform()->setParent(root);
+			emitterObj->getTransform()->name = "ParticleSystem";
+
+			ParticleSystem *system = new ParticleSystem(0.0f, rate, 1000000.0f, rate, 0.0f, rate, 0.2f);
+			emitterObj->addComponent(system);
+			system->createParticles(n, 1.0f, 2.0f, sparkle, 0.2f, root);
+			system->setPositionRange(0.1f, 0.1f, 0.1f);
+			system->setDirection(0, 0, 180 * Math::DEG2RAD);
+			system->setStartVelocity(2.0f, 5.0f);
+			system->setAcceleration(-2.0f, 1.0f);
+			system->setAlphaFade(1.0f, 0.0f);
+			system->emit(n / 2);
+		}
+	}
+
+	/*! Characters made of a chain of bones driven by a looping keyframe animation
+	  \param compressed	compile the first character's keyframes to a CompressedClip and play that on every character
+	  */
+	void BenchmarkApplication::createAnimation(bool compressed){
+		int characters = (count + CHARACTER_BONES - 1) / CHARACTER_BONES;
+		AnimationBinding *skeleton = NULL;			// every character has the same bones
+		CompressedClip *clip = NULL;
+
+		for (int c = 0; c < characters; c++) {
+			GameObject *character = new GameObject(this);
+			character->getTransform()->setLocalPosition(Vector3(
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent),
+				Math::randRange(-extent, extent)));
+			character->getTransform()->setParent(root);
+			character->getTransform()->name = "Character";
+
+			Transform *parent = character->getTransform();
+			for (int b = 0; b < CHARACTER_BONES; b++) {
+				GameObject *bone = new GameObject(this);
+				bone->setMesh(meshCache->getCube(0.1f));
+				bone->setMaterial(red);
+				bone->getTransform()->setLocalPosition(Vector3(0, 0.3f, 0));
+				bone->getTransform()->setParent(parent);
+				bone->getTransform()->name = "Bone" + std::to_string((long long)b);
+				parent = bone->getTransform();
+			}
+
+			Animation *anim = new Animation(2.0f);
+			character->addComponent(anim);
+			if (clip) anim->setClip(clip);
+			else if (skeleton) anim->setBinding(skeleton);
+			for (int b = 0; b < CHARACTER_BONES && clip == NULL; b++) {
+				std::string name = "Bone" + std::to_string((long long)b);
+				anim->addKey(name, 0.0f, Quaternion(), Vector3(0, 0.3f, 0));
+				anim->addKey(name, 1.0f, Quaternion(Vector3(0, 0, 0.2f)), Vector3(0, 0.3f, 0));
+				anim->addKey(name, 2.0f, Quaternion(), Vector3(0, 0.3f, 0));
+			}
+			anim->loop(true);
+			anim->play();
+			skeleton = anim->getBinding();
+			if (compressed && clip == NULL) {
+				clip = new CompressedClip(anim);
+				anim->setClip(clip);
+			}
+		}
+	}
+
+	//! A fractal terrain with about count vertices, and some objects following its surface
+	void BenchmarkApplication::createTerrain(){
+		int resolution = 16;
+		while ((resolution + 1) * (resolution + 1) < count && resolution < 4096)
+			resolution *= 2;
+
+		Material *grass = renderer->createMaterial(Renderer::PR_TERRAIN);
+		grass->setDiffuse(0.2f, 0.8f, 0.2f, 1);
+
+		float size = 2 * extent;
+		GameObject *terrainObj = new GameObject(this);
+		Terrain *terrain = new Terrain();
+		terrainObj->addComponent(terrain);
+		terrain->createFractalTerrain(resolution, size, size / 16, 2.0f);
+		terrainObj->setMaterial(grass);
+		terrainObj->getTransform()->setLocalPosition(Vector3(0, -extent / 2, 0));
+		terrainObj->getTransform()->setParent(root);
+		terrainObj->getTransform()->name = "Terrain";
+
+		for (int i = 0; i < TERRAIN_FOLLOWERS; i++) {
+			GameObject *follower = new GameObject(this);
+			follower->setMesh(meshCache->getCube(0.2f));
+			follower->setMaterial(red);
+			follower->addComponent(new TerrainFollower(terrain, 0.2f));
+			follower->getTransform()->setLocalPosition(Vector3(
+				Math::randRange(-extent, extent), 0,
+				Math::randRange(-extent, extent)));
+			follower->getTransform()->setParent(root);
+			follower->getTransform()->name = "Follower";
+		}
+	}
+
+	//! count particles in systems of SYSTEM_PARTICLES, sprayed at a terrain they bounce off
+	void BenchmarkApplication::createDebris(){
+		Material *grass = renderer->createMaterial(Renderer::PR_TERRAIN);
+		grass->setDiffuse(0.2f, 0.8f, 0.2f, 1);
+		Material *dust = renderer->createMaterial(Renderer::PR_TRANSPARENT);
+		dust->setDiffuse(0.6f, 0.5f, 0.4f, 1);
+		dust->setBlending(Material::BLEND_DEFAULT);
+		dust->setSortedDraw(true, true);
+
+		float size = 2 * extent;
+		float floor = -extent / 2;
+		GameObject *terrainObj = new GameObject(this);
+		Terrain *terrain = new Terrain();
+		terrainObj->addComponent(terrain);
+		terrain->createFractalTerrain(DEBRIS_RESOLUTION, size, size / 16, 2.0f);
+		terrainObj->setMaterial(grass);
+		terrainObj->getTransform()->setLocalPosition(Vector3(0, floor, 0));
+		terrainObj->getTransform()->setParent(root);
+		terrainObj->getTransform()->name = "Terrain";
+
+		int systems = (count + SYSTEM_PARTICLES - 1) / SYSTEM_PARTICLES;
+		for (int e = 0; e < systems; e++) {
+			int n = std::min(SYSTEM_PARTICLES, count - e * SYSTEM_PARTICLES);
+			float rate = n / 1.5f;
+
+			// just above the highest the terrain can be, spraying downwards
+			GameObject *emitterObj = new GameObject(this);
+			emitterObj->getTransform()->setLocalPosition(Vector3(
+				Math::randRange(-extent, extent) * 0.8f,
+				floor + size / 16 + 1.0f,
+				Math::randRange(-extent, extent) * 0.8f));
+			emitterObj->getTransform()->setParent(root);
+			emitterObj->getTransform()->name = "Debris";
+
+			ParticleSystem *system = new ParticleSystem(0.0f, rate, 1000000.0f, rate, 0.0f, rate, 0.2f);
+			emitterObj->addComponent(system);
+			system->createParticles(n, 1.0f, 2.0f, dust, 0.1f, root);
+			system->setPositionRange(0.5f, 0.1f, 0.5f);
+			system->setDirection(0, -90 * Math::DEG2RAD, 60 * Math::DEG2RAD);
+			system->setStartVelocity(2.0f, 5.0f);
+			system->setAlphaFade(1.0f, 0.0f);
+			system->setTerrainCollision(terrain, ParticleSystem::COLLIDE_BOUNCE, 0.5f);
+			system->emit(n / 2);
+		}
+	}
+
+	//! Many small systems spread well beyond the view, using emitter LOD
+	void BenchmarkApplication::createEffects(){
+		Material *smoke = renderer->createMaterial(Renderer::PR_TRANSPARENT);
+		smoke->setDiffuse(0.5f, 0.5f, 0.5f, 1);
+		smoke->setBlending(Material::BLEND_DEFAULT);
+		smoke->setSortedDraw(true, true);
+
+		int systems = (count + EFFECT_PARTICLES - 1) / EFFECT_PARTICLES;
+		for (int e = 0; e < systems; e++) {
+			int n = std::min(EFFECT_PARTICLES, count - e * EFFECT_PARTICLES);
+			float rate = n / 1.5f;
+
+			// the camera is at z = 2 * extent looking down -z, most of these are behind or beside it
+			GameObject *emitterObj = new GameObject(this);
+			emitterObj->getTransform()->setLocalPosition(Vector3(
+				Math::randRange(-4 * extent, 4 * extent),
+				Math::randRange(-extent, extent),
+				Math::randRange(-4 * extent, 4 * extent)));
+			emitterObj->getTransform()->setParent(root);
+			emitterObj->getTransform()->name = "Effect";
+
+			ParticleSystem *system = new ParticleSystem(0.0f, rate, 1000000.0f, rate, 0.0f, rate, 0.2f);
+			emitterObj->addComponent(system);
+			system->createParticles(n, 1.0f, 2.0f, smoke, 0.2f, root);
+			system->setPositionRange(0.1f, 0.1f, 0.1f);
+			system->setDirection(0, 90 * Math::DEG2RAD, 30 * Math::DEG2RAD);
+			system->setStartVelocity(0.5f, 1.0f);
+			system->setAlphaFade(1.0f, 0.0f);
+			system->setLOD(extent, 3 * extent, 4, 2.0f);
+			system->emit(n / 2);
+		}
+	}
+
+	void BenchmarkApplication::writeReport(std::ostream &out){
+		double frameCount = std::max(framesRun, 1);
+
+		out << std::fixed << std::setprecision(6);
+		out << "{\n";
+		out << "  \"scene\": \"" << scene << "\",\n";
+		out << "  \"count\": " << count << ",\n";
+		out << "  \"frames\": " << framesRun << ",\n";
+		out << "  \"frame_time\": " << frameTime << ",\n";
+		out << "  \"workers\": " << jobSystem->getWorkerCount() << ",\n";
+		out << "  \"flat_hierarchy\": " << (getHierarchy() != NULL ? "true" : "false") << ",\n";
+		out << "  \"total_seconds\": " << runTime << ",\n";
+		out << "  \"ms_per_frame\": " << runTime * 1000.0 / frameCount << ",\n";
+		out << "  \"phases\": {\n";
+		for (int i = 0; i < Profiler::PHASE_COUNT; i++) {
+			Profiler::Phase p = (Profiler::Phase)i;
+			out << "    \"" << Profiler::getName(p) << "\": { "
+				<< "\"ms_per_frame\": " << Profiler::getSeconds(p) * 1000.0 / frameCount << ", "
+				<< "\"total_seconds\": " << Profiler::getSeconds(p) << ", "
+				<< "\"calls\": " << Profiler::getCalls(p) << " }"
+				<< (i < Profiler::PHASE_COUNT - 1 ? ",\n" : "\n");
+		}
+		out << "  },\n";
+		out << "  \"last_frame\": { "
+			<< "\"draws\": " << renderer->draws_last_frame << ", "
+			<< "\"polygons\": " << renderer->polys_last_frame << ", "
+			<< "\"material_switches\": " << renderer->material_switches_last_frame << " }\n";
+		out << "}\n";
+	}
+}
@@ -0,0 +1,70 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// benchmarkapplication.h
+//
+// Headless application that builds a parameterised test scene, runs it for a fixed number
+// of frames at a fixed time step and reports the time spent in each phase as JSON.
+
+#ifndef BENCHMARKAPPLICATION_H
+#define BENCHMARKAPPLICATION_H
+
+#include <string>
+#include <ostream>
+#include "HeadlessApplication.h"
+
+namespace T3D
+{
+	class Material;
+
+	class BenchmarkApplication :
+		public HeadlessApplication
+	{
+	public:
+		/*! Constructor
+		  \param scene		one of the names from getSceneNames()
+		  \param count		scene size, roughly the number of objects (terrain: vertices)
+		  \param frames		number of frames to run
+		  \param workers	number of job system workers (1 runs everything on the main thread)
+		  \param flat		store the scene graph matrices in a flattened TransformHierarchy
+		  */
+		BenchmarkApplication(std::string scene, int count, int frames, int workers = 1, bool flat = false);
+		virtual ~BenchmarkApplication(void);
+
+		bool init();
+		int run(void);
+
+		/*! Brings every world matrix up to date, so the world_matrices phase measures them
+		  Without a flat hierarchy the engine leaves them to be computed lazily while culling and
+		  drawing, which would hide their cost in those phases.
+		  */
+		void updateWorldMatrices();
+
+		//! Writes the results of the last run as a JSON object
+		void writeReport(std::ostream &out);
+
+		//! Names of the available scenes, separated by spaces
+		static const char* getSceneNames(){ return "spheres chain particles particlesystem animation animationclip terrain debris effects"; }
+
+	protected:
+		void createSpheres();
+		void createChains();
+		void createParticles();
+		void createParticleSystems();
+		void createAnimation(bool compressed);
+		void createTerrain();
+		void createDebris();
+		void createEffects();
+
+		std::string scene;
+		int count;
+		int workers;
+		bool flat;
+		float extent;			// half width of the volume the scene is spread over
+		Material *red;
+	};
+}
+
+#endif
+
@@ -6,11 +6,10 @@
 //
 // Billboard.cpp
 //
-// A billboard component.  Creates a plane mesh and adds it to the game object.  
+// A billboard component.  Adds a plane mesh, shared with all billboards of the same density, to the game object.  
 // Update method supports spherical and cylindrical billboarding to face the plane towards the camera
 
 #include "Billboard.h"
-#include "PlaneMesh.h"
 #include "GameObject.h"
 #include "T3DApplication.h"
 #include "Camera.h"
@@ -24,8 +23,7 @@ namespace T3D
 	void Billboard::init(GameObject* go){
 		gameObject = go;
 		
-		PlaneMesh *mesh = new PlaneMesh(10); 
-		gameObject->setMesh(mesh);
+		gameObject->setMesh(go->getApp()->getMeshCache()->getPlane(density));
 	}
 	
 	void Billboard::update(float dt){	
@@ -6,7 +6,7 @@
 //
 // Billboard.cpp
 //
-// A billboard component.  Creates a plane mesh and adds it to the game object.  
+// A billboard component.  Adds a plane mesh, shared with all billboards of the same density, to the game object.  
 // Update method supports spherical and cylindrical billboarding to face the plane towards the camera
 
 #ifndef BILLBOARD_H
@@ -21,11 +21,16 @@ namespace T3D
 		public Component
 	{
 	public:
-		Billboard(Transform* camera, bool lockY = false) : lockY(lockY),camera(camera){};
+		/*! \param camera	Transform the billboard turns to face
+		  \param lockY		Only turn about the y axis
+		  \param density	Quads along each side of the plane, one (two triangles) is enough unless vertex lighting needs more
+		  */
+		Billboard(Transform* camera, bool lockY = false, int density = 1) : lockY(lockY),camera(camera),density(density){};
 		~Billboard(void);
 
 		virtual void update(float dt);
 		virtual void init(GameObject* go);
+		virtual UpdateAccess getUpdateAccess() const { return ACCESS_READ_TRANSFORMS; }		// reads the camera
 
 		void lockYAxis(){ lockY = true; }
 		void unlockYAxis(){ lockY = false; }
@@ -33,6 +38,7 @@ namespace T3D
 	private:
 		Transform* camera;
 		bool lockY;
+		int density;
 	};
 }
 
@@ -8,16 +8,19 @@
 //
 // Bone class used for animation in conjunction with the Animation class
 
+#include <algorithm>
 #include "bone.h"
 
 namespace T3D
 {	
-	bool frameCompare (KeyFrame f1, KeyFrame f2) { 
+	bool frameCompare (const KeyFrame &f1, const KeyFrame &f2) { 
 		return (f1.time<f2.time); 
 	}
 
 	Bone::Bone(void)
 	{
+		transform = NULL;
+		cursor = 0;
 	}
 
 
@@ -27,42 +30,83 @@ namespace T3D
 
 	
 	void Bone::addFrame(KeyFrame f){
-		if (keyframes.empty()){
-			keyframes.push_back(f);
-		} else {			
-			std::vector<KeyFrame>::iterator kfi = keyframes.begin();
-			while (kfi!=keyframes.end() && f.time>(*kfi).time){
-				kfi++;
-			}
-			keyframes.insert(kfi,f);
+		cursor = 0;
+		if (keyframes.empty() || f.time>keyframes.back().time){
+			keyframes.push_back(f);			// keys usually arrive in order
+		} else {
+			// before any keyframes at the same time
+			keyframes.insert(std::lower_bound(keyframes.begin(),keyframes.end(),f,frameCompare),f);
 		}
 	}
-	
+
+	void Bone::addFrames(const KeyFrame *frames, int count){
+		cursor = 0;
+		keyframes.insert(keyframes.end(),frames,frames+count);
+		std::stable_sort(keyframes.begin(),keyframes.end(),frameCompare);
+	}
+
+	/*! Finds the keyframe that starts the segment containing time
+	  Playing forwards time only moves on a little each update, so the search starts from the
+	  last segment found and steps forward.  Seeks, loops and big jumps use a binary search.
+	  \param time		must be before the last keyframe
+	  \return			index of the last keyframe at or before time, or -1 if time is before them all
+	  */
+	int Bone::findFrame(float time){
+		int last = (int)keyframes.size()-1;
+		if (cursor<0 || cursor>=last || time<keyframes[cursor].time){
+			cursor = 0;
+			if (time<keyframes[0].time) return -1;
+		}
+
+		for (int step=0; step<MAX_CURSOR_STEPS; step++){
+			if (time<keyframes[cursor+1].time) return cursor;
+			cursor++;
+		}
+
+		KeyFrame key;
+		key.time = time;
+		cursor = (int)(std::upper_bound(keyframes.begin()+cursor,keyframes.end(),key,frameCompare)-keyframes.begin())-1;
+		return cursor;
+	}
 
 
 	void Bone::update(float time){
-		int frame = 0;
-		if (!keyframes.empty())
+		int from, to;
+		float alpha;
+		if (getSegment(time,from,to,alpha))
 		{
-			if (time >= keyframes[keyframes.size()-1].time) {		// reached end of sequence?
-				// set to last keyframe
-				transform->setLocalPosition(keyframes[keyframes.size()-1].position);
-				transform->setLocalRotation(keyframes[keyframes.size()-1].rotation);
-			}
-			else
-			{
-				// find position in sequence
-				while (time>=keyframes[frame].time){
-					frame++;
-				}
+			if (from == to) {
+				transform->setLocalPositionRotation(keyframes[from].position,keyframes[from].rotation);
+			} else {
 				// Set to interpolated state bequence keyframes
-				float alpha = (time-keyframes[frame-1].time)/(keyframes[frame].time-keyframes[frame-1].time);
-				transform->setLocalPosition(Vector3::lerp(keyframes[frame-1].position,keyframes[frame].position,alpha));
-				transform->setLocalRotation(Quaternion::slerp(keyframes[frame-1].rotation,keyframes[frame].rotation,alpha));
+				transform->setLocalPositionRotation(Vector3::lerp(keyframes[from].position,keyframes[to].position,alpha),
+					Quaternion::slerp(keyframes[from].rotation,keyframes[to].rotation,alpha));
 			}
 		}
 	}
 
+	bool Bone::getSegment(float time, int &from, int &to, float &alpha){
+		if (keyframes.empty()) return false;
+
+		int last = (int)keyframes.size()-1;
+		alpha = 0;
+		if (time >= keyframes[last].time) {		// reached end of sequence?
+			from = to = last;
+			return true;
+		}
+
+		// find position in sequence
+		from = findFrame(time);
+		if (from < 0) {
+			// before the first keyframe, hold it
+			from = to = 0;
+			return true;
+		}
+		to = from+1;
+		alpha = (time-keyframes[from].time)/(keyframes[to].time-keyframes[from].time);
+		return true;
+	}
+
 	void Bone::printKeyFrames(){
 		std::vector<KeyFrame>::iterator kfi;
 		for (kfi=keyframes.begin(); kfi!=keyframes.end(); kfi++){
@@ -33,13 +33,36 @@ namespace T3D
 		void interpolate(int numFrames);
 		void update(float time);
 
+		/*! Finds the keyframes either side of a time
+		  Before the first or after the last keyframe both are that keyframe.
+		  \param time		time in the animation
+		  \param from		keyframe at or before time
+		  \param to		keyframe after time
+		  \param alpha		how far time is from from to to, 0 to 1
+		  \return			false if there are no keyframes
+		  */
+		bool getSegment(float time, int &from, int &to, float &alpha);
+
 		void addFrame(KeyFrame f);
 
+		/*! Adds many keyframes at once, sorting once rather than inserting each
+		  \param frames	the keyframes, in any order
+		  \param count		number of keyframes
+		  */
+		void addFrames(const KeyFrame *frames, int count);
+
 		void printFrames();
 		void printKeyFrames();
 
 		Transform* transform;
 		std::vector<KeyFrame> keyframes;
+
+	protected:
+		int findFrame(float time);
+
+		static const int MAX_CURSOR_STEPS = 4;	// keyframes to step forward before searching instead
+
+		int cursor;				// keyframe starting the segment found last update
 	};
 }
 
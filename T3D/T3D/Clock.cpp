@@ -0,0 +1,59 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// clock.cpp
+//
+// Monotonic high resolution clock (microseconds) used to time frames
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+#include "Clock.h"
+
+namespace T3D
+{
+	Clock::Clock(void)
+	{
+		reset();
+	}
+
+	void Clock::reset()
+	{
+		start = last = microseconds();
+	}
+
+	double Clock::tick()
+	{
+		long long now = microseconds();
+		double seconds = (now - last) / 1000000.0;
+		last = now;
+		return seconds;
+	}
+
+	double Clock::elapsed() const
+	{
+		return (microseconds() - start) / 1000000.0;
+	}
+
+	long long Clock::microseconds()
+	{
+#ifdef _WIN32
+		// std::chrono::high_resolution_clock only has millisecond resolution in VS2013
+		static LARGE_INTEGER frequency = { 0 };
+		if (frequency.QuadPart == 0)
+			QueryPerformanceFrequency(&frequency);
+
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+		return (counter.QuadPart / frequency.QuadPart) * 1000000 +
+			(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+#else
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+}
@@ -0,0 +1,38 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// clock.h
+//
+// Monotonic high resolution clock (microseconds) used to time frames
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+namespace T3D
+{
+	class Clock
+	{
+	public:
+		Clock(void);
+
+		//! Restarts timing from now
+		void reset();
+
+		//! Seconds since the last call to tick (or reset)
+		double tick();
+
+		//! Seconds since reset, without affecting tick
+		double elapsed() const;
+
+		//! Current time in microseconds from an arbitrary fixed point
+		static long long microseconds();
+
+	private:
+		long long start;
+		long long last;
+	};
+}
+
+#endif
+
@@ -12,16 +12,40 @@
 
 #include "Component.h"
 #include "GameObject.h"
+#include "ComponentManager.h"
 
 namespace T3D
 {
 	Component::Component(void)
 	{
 		gameObject = NULL;
+		manager = NULL;
+		bucket = NULL;
+		bucketSlot = -1;
+	}
+
+
+	Component::Component(const Component& c)
+	{
+		gameObject = c.gameObject;
+		manager = NULL;
+		bucket = NULL;
+		bucketSlot = -1;
 	}
 
 
 	Component::~Component(void)
 	{
+		if (manager != NULL)
+			manager->remove(this);
+	}
+
+	void Component::updateAll(Component** components, int count, float dt)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			if (components[i] != NULL)
+				components[i]->update(dt);
+		}
 	}
 }
@@ -16,18 +16,51 @@
 namespace T3D
 {
 	class GameObject;
+	class ComponentManager;
+	struct ComponentBucket;
 
 	class Component
 	{
 	public:
+		//! What a component touches during update, used to decide if a type can update in parallel
+		enum UpdateAccess {
+			ACCESS_OWN_TRANSFORM,		//!< writes only its own game object and the Transforms below it
+			ACCESS_READ_TRANSFORMS,		//!< as above, and reads Transforms that no component of the same type writes
+			ACCESS_GLOBAL				//!< anything else, always updated serially
+		};
+
 		Component(void);
+		Component(const Component& c);			// copies are not registered for updates
 		virtual ~Component(void);
 
+		Component& operator=(const Component& c){ gameObject = c.gameObject; return *this; }
+
 		virtual void update(float dt){};
 		virtual void init(GameObject* go){ gameObject = go; };
 
+		/*! Updates a batch of components that all share this component's concrete type
+		  Override to process a whole type at once; the default calls update on each in turn
+		  \param components	the components to update, entries may be NULL
+		  \param count		number of entries
+		  \param dt			time since the last update (in seconds)
+		  */
+		virtual void updateAll(Component** components, int count, float dt);
+
+		/*! Declares what update touches, the same for every instance of a type
+		  Defaults to ACCESS_GLOBAL so components are only run in parallel when they opt in
+		  */
+		virtual UpdateAccess getUpdateAccess() const { return ACCESS_GLOBAL; }
+
 	public:
 		GameObject *gameObject;
+
+	private:
+		friend class ComponentManager;
+		friend struct ComponentBucket;
+
+		ComponentManager *manager;		// set while registered for updates
+		ComponentBucket *bucket;
+		int bucketSlot;
 	};
 }
 
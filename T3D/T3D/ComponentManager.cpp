@@ -0,0 +1,206 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// componentmanager.cpp
+//
+// Keeps every attached component in a contiguous list for its concrete type
+// The application updates components one type at a time rather than walking the scene graph
+
+#include <algorithm>
+#include "ComponentManager.h"
+#include "Component.h"
+#include "T3DApplication.h"
+#include "Transform.h"
+
+namespace T3D
+{
+	void ComponentBucket::remove(Component *c)
+	{
+		components[c->bucketSlot] = NULL;
+		c->manager = NULL;
+		c->bucket = NULL;
+		c->bucketSlot = -1;
+		holes = true;
+	}
+
+	ComponentManager::ComponentManager(T3DApplication *app) : app(app)
+	{
+		updating = false;
+		worldsCurrent = false;
+		deletionsAtRefresh = 0;
+	}
+
+	ComponentManager::~ComponentManager(void)
+	{
+		// components outlive the manager only at shutdown, just stop them pointing at us
+		for (unsigned int b = 0; b < buckets.size(); ++b)
+		{
+			std::vector<Component*> &list = buckets[b]->components;
+			for (unsigned int i = 0; i < list.size(); ++i)
+			{
+				if (list[i] != NULL)
+				{
+					list[i]->manager = NULL;
+					list[i]->bucket = NULL;
+					list[i]->bucketSlot = -1;
+				}
+			}
+			delete buckets[b];
+		}
+		for (unsigned int i = 0; i < pending.size(); ++i)
+			pending[i]->manager = NULL;
+	}
+
+	void ComponentManager::add(Component *c)
+	{
+		std::lock_guard<std::mutex> lk(lock);
+		if (c->manager != NULL) return;
+
+		c->manager = this;
+		if (updating)
+			pending.push_back(c);
+		else
+			insert(c);
+	}
+
+	void ComponentManager::remove(Component *c)
+	{
+		std::lock_guard<std::mutex> lk(lock);
+		if (c->bucket != NULL)
+		{
+			c->bucket->remove(c);
+		}
+		else
+		{
+			std::vector<Component*>::iterator it = std::find(pending.begin(), pending.end(), c);
+			if (it != pending.end())
+				pending.erase(it);
+			c->manager = NULL;
+		}
+	}
+
+	void ComponentManager::insert(Component *c)
+	{
+		std::type_index type(typeid(*c));
+		ComponentBucket *bucket;
+
+		std::map<std::type_index, ComponentBucket*>::iterator it = lookup.find(type);
+		if (it == lookup.end())
+		{
+			bucket = new ComponentBucket(typeid(*c).name());
+			buckets.push_back(bucket);
+			lookup.insert(std::make_pair(type, bucket));
+		}
+		else
+		{
+			bucket = it->second;
+		}
+
+		c->bucket = bucket;
+		c->bucketSlot = (int)bucket->components.size();
+		bucket->components.push_back(c);
+	}
+
+	// close up the gaps left by removed components, keeping the update order
+	void ComponentManager::compact(ComponentBucket *bucket)
+	{
+		std::vector<Component*> &list = bucket->components;
+		unsigned int out = 0;
+		for (unsigned int i = 0; i < list.size(); ++i)
+		{
+			if (list[i] != NULL)
+			{
+				list[out] = list[i];
+				list[out]->bucketSlot = out;
+				out++;
+			}
+		}
+		list.resize(out);
+		bucket->holes = false;
+	}
+
+	// before a parallel bucket, so the lazy getters never write to a shared ancestor.  The whole
+	// scene is walked once a frame, after that only the subtrees recorded as going out of date,
+	// unless a transform has been deleted since and the records may no longer be valid
+	void ComponentManager::refreshWorldMatrices()
+	{
+		if (worldsCurrent && Transform::deletions == deletionsAtRefresh)
+		{
+			for (unsigned int w = 0; w < staleWorlds.size(); ++w)
+			{
+				for (unsigned int i = 0; i < staleWorlds[w].size(); ++i)
+					staleWorlds[w][i]->refreshWorldMatrices();
+				staleWorlds[w].clear();
+			}
+		}
+		else
+		{
+			for (unsigned int w = 0; w < staleWorlds.size(); ++w)
+				staleWorlds[w].clear();
+			app->refreshWorldMatrices();
+			Transform::staleWorlds = &staleWorlds[0];
+			deletionsAtRefresh = Transform::deletions;
+			worldsCurrent = true;
+		}
+	}
+
+	void ComponentManager::update(float dt)
+	{
+		JobSystem *jobs = app->getJobSystem();
+		int workers = jobs->getWorkerCount();
+		bool parallel = workers > 1;
+
+		if (parallel)
+		{
+			deferredBounds.resize(workers);
+			staleWorlds.resize(workers);
+		}
+		worldsCurrent = false;
+
+		updating = true;
+
+		for (unsigned int b = 0; b < buckets.size(); ++b)
+		{
+			ComponentBucket *bucket = buckets[b];
+			if (bucket->holes)
+				compact(bucket);
+
+			int count = (int)bucket->components.size();
+			if (count == 0) continue;
+
+			// any instance can run the batch for its type
+			Component *first = bucket->components[0];
+			Component **list = &bucket->components[0];
+
+			if (parallel && count > PARALLEL_GRAIN && first->getUpdateAccess() != Component::ACCESS_GLOBAL)
+			{
+				refreshWorldMatrices();
+
+				// bound changes reach shared ancestors too, so those are marked afterwards on this
+				// thread, starting from just the transforms each worker recorded
+				Transform::deferredBounds = &deferredBounds[0];
+				jobs->parallelFor(count, PARALLEL_GRAIN, [first, list, dt](int begin, int end, int worker) {
+					first->updateAll(list + begin, end - begin, dt);
+				});
+				Transform::deferredBounds = NULL;
+				for (int w = 0; w < workers; ++w)
+					Transform::propagateBoundUpdates(deferredBounds[w]);
+			}
+			else
+			{
+				first->updateAll(list, count, dt);
+			}
+		}
+
+		updating = false;
+
+		Transform::staleWorlds = NULL;
+		for (unsigned int w = 0; w < staleWorlds.size(); ++w)
+			staleWorlds[w].clear();
+
+		for (unsigned int i = 0; i < pending.size(); ++i)
+			insert(pending[i]);
+		pending.clear();
+	}
+}
@@ -0,0 +1,87 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// componentmanager.h
+//
+// Keeps every attached component in a contiguous list for its concrete type
+// The application updates components one type at a time rather than walking the scene graph
+
+#ifndef COMPONENTMANAGER_H
+#define COMPONENTMANAGER_H
+
+#include <vector>
+#include <map>
+#include <typeinfo>
+#include <typeindex>
+#include <mutex>
+
+namespace T3D
+{
+	class Component;
+	class T3DApplication;
+	class Transform;
+
+	//! All live components of one concrete type, in the order they were added
+	struct ComponentBucket
+	{
+		ComponentBucket(const char *typeName) : typeName(typeName), holes(false) {}
+
+		void remove(Component *c);
+
+		const char *typeName;
+		std::vector<Component*> components;		// may hold NULLs until the next compaction
+		bool holes;
+	};
+
+	class ComponentManager
+	{
+	public:
+		ComponentManager(T3DApplication *app);
+		virtual ~ComponentManager(void);
+
+		/*! Registers a component for updates
+		  Components added while an update is running are picked up next frame
+		  \param c		the component, already initialised
+		  */
+		void add(Component *c);
+
+		//! Stops updating a component, called automatically when a component is deleted
+		void remove(Component *c);
+
+		/*! Updates every registered component, one type at a time
+		  Each type is handed to Component::updateAll, which by default calls update on each.
+		  When the application has more than one worker, types that declare ACCESS_OWN_TRANSFORM
+		  or ACCESS_READ_TRANSFORMS are split across the workers; ACCESS_GLOBAL types stay serial.
+		  \param dt		time since the last update (in seconds)
+		  */
+		void update(float dt);
+
+		int getBucketCount() const { return (int)buckets.size(); }
+		ComponentBucket* getBucket(int i){ return buckets[i]; }
+
+	private:
+		void insert(Component *c);
+		void compact(ComponentBucket *bucket);
+		void refreshWorldMatrices();
+
+		static const int PARALLEL_GRAIN = 128;			// components per job
+
+		T3DApplication *app;
+		std::mutex lock;								// guards registration from worker threads
+
+		std::vector<ComponentBucket*> buckets;				// in order of first registration
+		std::map<std::type_index, ComponentBucket*> lookup;
+		std::vector<Component*> pending;					// added during an update
+		bool updating;
+
+		// per worker, see Transform::deferredBounds and Transform::staleWorlds
+		std::vector<std::vector<Transform*> > deferredBounds;
+		std::vector<std::vector<Transform*> > staleWorlds;
+		bool worldsCurrent;								// refreshed this frame, apart from staleWorlds
+		unsigned int deletionsAtRefresh;				// Transform::deletions when last refreshed
+	};
+}
+
+#endif
+
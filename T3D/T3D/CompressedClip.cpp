@@ -0,0 +1,219 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming
+// =========================================================================================
+//
+// CompressedClip.cpp
+//
+// An animation's keyframes resampled at a fixed rate and quantised into one block of memory
+// Rotations are stored smallest three in 48 bits and positions as 16 bits per axis within each
+// bone's range.  A bone that doesn't rotate or move stores that channel once.  Frames are evenly
+// spaced, so sampling a time is an index rather than a search.
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include "CompressedClip.h"
+#include "Animation.h"
+#include "AnimationBinding.h"
+
+namespace T3D
+{
+	static const int ROTATION_BITS = 15;					// per component, with 2 bits saying which was dropped
+	static const float ROTATION_STEPS = (float)((1 << ROTATION_BITS) - 1);
+	static const float POSITION_STEPS = 65535.0f;
+	static const float SQRT2 = 1.41421356f;					// the smaller three components are within +-1/sqrt2
+	static const int KEPT[4][3] = { {1,2,3}, {0,2,3}, {0,1,3}, {0,1,2} };	// components stored when each is dropped
+
+	CompressedClip::CompressedClip(Animation *source, float sampleRate, float rotationTolerance, float positionTolerance)
+	{
+		binding = source->binding;
+		if (binding) binding->addRef();
+		else std::cout << "ERROR: CompressedClip made from an animation with no bones\n";
+
+		Header h;
+		h.duration = source->duration;
+		h.frameCount = 1;
+		if (h.duration > 0 && sampleRate > 0)
+			h.frameCount = (int)ceil(h.duration * sampleRate - 0.0001f) + 1;
+		h.frameRate = h.frameCount > 1 ? (h.frameCount - 1) / h.duration : 0;
+		h.trackCount = 0;
+
+		std::vector<Track> trackList;
+		std::vector<Sample> sampleList;
+		std::vector<Quaternion> rotations(h.frameCount);
+		std::vector<Vector3> positions(h.frameCount);
+		float cosTolerance = cos(rotationTolerance * 0.5f);
+
+		for (BoneMap::iterator it = source->bones.begin(); it != source->bones.end(); ++it){
+			Bone *bone = it->second;
+			int index = binding ? binding->findBone(it->first) : -1;
+			if (index < 0 || bone->keyframes.empty()) continue;
+
+			// resample, interpolating as Bone::update does
+			for (int f = 0; f < h.frameCount; ++f){
+				float time = f == h.frameCount - 1 ? h.duration : f / h.frameRate;
+				int from, to;
+				float alpha;
+				bone->getSegment(time, from, to, alpha);
+				const KeyFrame &a = bone->keyframes[from];
+				const KeyFrame &b = bone->keyframes[to];
+				positions[f] = Vector3::lerp(a.position, b.position, alpha);
+				rotations[f] = from == to ? a.rotation : Quaternion::slerp(a.rotation, b.rotation, alpha);
+			}
+
+			Track track;
+			track.bone = index;
+			track.rotationStride = 0;
+			track.positionStride = 0;
+
+			Vector3 lo = positions[0], hi = positions[0];
+			for (int f = 1; f < h.frameCount; ++f){
+				if (fabs(Quaternion::dot(rotations[0], rotations[f])) < cosTolerance)
+					track.rotationStride = 1;
+				if ((positions[f] - positions[0]).length() > positionTolerance)
+					track.positionStride = 1;
+				lo.x = std::min(lo.x, positions[f].x); hi.x = std::max(hi.x, positions[f].x);
+				lo.y = std::min(lo.y, positions[f].y); hi.y = std::max(hi.y, positions[f].y);
+				lo.z = std::min(lo.z, positions[f].z); hi.z = std::max(hi.z, positions[f].z);
+			}
+			if (track.positionStride == 0) hi = lo = positions[0];
+
+			track.positionMin[0] = lo.x; track.positionScale[0] = (hi.x - lo.x) / POSITION_STEPS;
+			track.positionMin[1] = lo.y; track.positionScale[1] = (hi.y - lo.y) / POSITION_STEPS;
+			track.positionMin[2] = lo.z; track.positionScale[2] = (hi.z - lo.z) / POSITION_STEPS;
+
+			track.rotations = (unsigned int)sampleList.size();
+			int count = track.rotationStride ? h.frameCount : 1;
+			for (int f = 0; f < count; ++f)
+				sampleList.push_back(packRotation(rotations[f]));
+
+			track.positions = (unsigned int)sampleList.size();
+			count = track.positionStride ? h.frameCount : 1;
+			for (int f = 0; f < count; ++f){
+				Sample s;
+				float p[3] = { positions[f].x, positions[f].y, positions[f].z };
+				for (int i = 0; i < 3; ++i){
+					float q = track.positionScale[i] > 0 ? (p[i] - track.positionMin[i]) / track.positionScale[i] : 0;
+					s.v[i] = (unsigned short)std::min(POSITION_STEPS, std::max(0.0f, q + 0.5f));
+				}
+				sampleList.push_back(s);
+			}
+
+			trackList.push_back(track);
+		}
+		h.trackCount = (int)trackList.size();
+
+		// everything in one block
+		blob.resize(sizeof(Header) + sizeof(Track)*trackList.size() + sizeof(Sample)*sampleList.size());
+		memcpy(&blob[0], &h, sizeof(Header));
+		if (!trackList.empty())
+			memcpy(&blob[sizeof(Header)], &trackList[0], sizeof(Track)*trackList.size());
+		if (!sampleList.empty())
+			memcpy(&blob[sizeof(Header) + sizeof(Track)*trackList.size()], &sampleList[0], sizeof(Sample)*sampleList.size());
+	}
+
+	CompressedClip::~CompressedClip(void)
+	{
+		if (binding) binding->release();
+	}
+
+	void CompressedClip::getFrame(float time, int &frame, float &alpha) const
+	{
+		const Header *h = header();
+		float f = std::min(std::max(time * h->frameRate, 0.0f), (float)(h->frameCount - 1));
+		frame = (int)f;
+		if (frame >= h->frameCount - 1){
+			frame = h->frameCount - 1;
+			alpha = 0;
+		} else {
+			alpha = f - frame;
+		}
+	}
+
+	void CompressedClip::decode(int track, int frame, Vector3 &position, Quaternion &rotation) const
+	{
+		const Track &t = tracks()[track];
+		const Sample *s = samples();
+
+		rotation = unpackRotation(s[t.rotations + frame*t.rotationStride]);
+
+		const Sample &p = s[t.positions + frame*t.positionStride];
+		position.x = t.positionMin[0] + p.v[0]*t.positionScale[0];
+		position.y = t.positionMin[1] + p.v[1]*t.positionScale[1];
+		position.z = t.positionMin[2] + p.v[2]*t.positionScale[2];
+	}
+
+	void CompressedClip::decodeFrame(int frame, const Pose &pose, int first) const
+	{
+		const Track *t = tracks();
+		const Sample *s = samples();
+
+		for (int i = 0, n = first; i < getTrackCount(); ++i, ++n){
+			Quaternion q = unpackRotation(s[t[i].rotations + frame*t[i].rotationStride]);
+			pose.s[n] = q.s; pose.qx[n] = q.v.x; pose.qy[n] = q.v.y; pose.qz[n] = q.v.z;
+
+			const Sample &p = s[t[i].positions + frame*t[i].positionStride];
+			pose.x[n] = t[i].positionMin[0] + p.v[0]*t[i].positionScale[0];
+			pose.y[n] = t[i].positionMin[1] + p.v[1]*t[i].positionScale[1];
+			pose.z[n] = t[i].positionMin[2] + p.v[2]*t[i].positionScale[2];
+		}
+	}
+
+	unsigned int CompressedClip::getSourceSize(Animation *source)
+	{
+		unsigned int size = 0;
+		for (BoneMap::iterator it = source->bones.begin(); it != source->bones.end(); ++it)
+			size += (unsigned int)(it->second->keyframes.size() * sizeof(KeyFrame));
+		return size;
+	}
+
+	/*! Packs a unit quaternion into 48 bits
+	  The largest component is dropped, it can be rebuilt from the others as the length is 1.  The
+	  quaternion is negated if needed to make it positive, so no sign is stored.  That leaves 2 bits
+	  for which component was dropped and 15 bits for each of the other three.
+	  */
+	CompressedClip::Sample CompressedClip::packRotation(const Quaternion &q)
+	{
+		float c[4] = { q.s, q.v.x, q.v.y, q.v.z };
+		int largest = 0;
+		for (int i = 1; i < 4; ++i)
+			if (fabs(c[i]) > fabs(c[largest])) largest = i;
+		float sign = c[largest] < 0 ? -1.0f : 1.0f;
+
+		unsigned long long bits = (unsigned long long)largest;
+		for (int i = 0; i < 3; ++i){
+			float v = (c[KEPT[largest][i]] * sign * SQRT2 + 1.0f) * 0.5f * ROTATION_STEPS + 0.5f;
+			bits = (bits << ROTATION_BITS) | (unsigned long long)std::min(ROTATION_STEPS, std::max(0.0f, v));
+		}
+
+		Sample s;
+		s.v[0] = (unsigned short)(bits >> 32);
+		s.v[1] = (unsigned short)(bits >> 16);
+		s.v[2] = (unsigned short)bits;
+		return s;
+	}
+
+	Quaternion CompressedClip::unpackRotation(const Sample &s)
+	{
+		// split the 48 bits with 32 bit operations, which are cheaper on Win32 builds
+		int largest = (s.v[0] >> 13) & 3;
+		unsigned int q0 = ((s.v[0] & 0x1fff) << 2) | (s.v[1] >> 14);
+		unsigned int q1 = ((s.v[1] & 0x3fff) << 1) | (s.v[2] >> 15);
+		unsigned int q2 = s.v[2] & 0x7fff;
+
+		const float scale = 2.0f / (ROTATION_STEPS * SQRT2);
+		const float offset = -1.0f / SQRT2;
+		float a = q0 * scale + offset;
+		float b = q1 * scale + offset;
+		float d = q2 * scale + offset;
+
+		float c[4];
+		c[KEPT[largest][0]] = a;
+		c[KEPT[largest][1]] = b;
+		c[KEPT[largest][2]] = d;
+		c[largest] = sqrt(std::max(0.0f, 1.0f - a*a - b*b - d*d));
+
+		return Quaternion(c[0], c[1], c[2], c[3]);
+	}
+}
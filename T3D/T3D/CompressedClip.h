@@ -0,0 +1,117 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming
+// =========================================================================================
+//
+// CompressedClip.h
+//
+// An animation's keyframes resampled at a fixed rate and quantised into one block of memory
+// Rotations are stored smallest three in 48 bits and positions as 16 bits per axis within each
+// bone's range.  A bone that doesn't rotate or move stores that channel once.  Frames are evenly
+// spaced, so sampling a time is an index rather than a search.
+
+#ifndef COMPRESSEDCLIP_H
+#define COMPRESSEDCLIP_H
+
+#include <vector>
+#include "Vector3.h"
+#include "Quaternion.h"
+#include "RefCounted.h"
+
+namespace T3D
+{
+	class Animation;
+	class AnimationBinding;
+
+	//! Shared by any number of animations, Animation::setClip takes a reference and the animation's destructor releases it
+	class CompressedClip : public RefCounted
+	{
+	public:
+		/*! Compiles an animation's keyframes
+		  \param source				animation with all its keys added, its binding is shared by the clip
+		  \param sampleRate			frames per second, adjusted slightly so the last frame lands on the duration
+		  \param rotationTolerance	radians a bone may turn from its first frame and still be stored once
+		  \param positionTolerance	distance a bone may move from its first frame and still be stored once
+		  */
+		CompressedClip(Animation *source, float sampleRate = 30.0f,
+			float rotationTolerance = 0.001f, float positionTolerance = 0.001f);
+		virtual ~CompressedClip(void);
+
+		float getDuration() const { return header()->duration; }
+		int getFrameCount() const { return header()->frameCount; }
+		int getTrackCount() const { return header()->trackCount; }
+		AnimationBinding* getBinding(){ return binding; }
+
+		//! Bytes used by the clip's data
+		unsigned int getSize() const { return (unsigned int)blob.size(); }
+
+		//! Binding index of the bone a track animates
+		int getTrackBone(int track) const { return tracks()[track].bone; }
+
+		/*! Finds the frames either side of a time
+		  \param time		time in the clip, clamped to 0..duration
+		  \param frame	frame at or before time, the next frame is frame+1 unless alpha is 0
+		  \param alpha	how far time is from frame to the next, 0 to 1
+		  */
+		void getFrame(float time, int &frame, float &alpha) const;
+
+		/*! Decodes one bone's state at a frame
+		  The rotation may come back negated, as q and -q are the same rotation.
+		  */
+		void decode(int track, int frame, Vector3 &position, Quaternion &rotation) const;
+
+		//! Structure of arrays pose buffer, as Animation::updateAll blends
+		struct Pose
+		{
+			float *x, *y, *z;		// position
+			float *s, *qx, *qy, *qz;	// rotation
+		};
+
+		/*! Decodes every track at a frame, the same as calling decode for each
+		  \param frame	frame to decode
+		  \param pose		receives getTrackCount() bones
+		  \param first	where in the pose buffer track 0 goes
+		  */
+		void decodeFrame(int frame, const Pose &pose, int first) const;
+
+		//! Bytes the keyframes of an uncompressed animation use, for comparison with getSize()
+		static unsigned int getSourceSize(Animation *source);
+
+	private:
+		struct Header
+		{
+			float duration;
+			float frameRate;			// frames per second
+			int frameCount;
+			int trackCount;
+		};
+
+		struct Track
+		{
+			int bone;					// binding index
+			float positionMin[3];
+			float positionScale[3];		// quantised step per axis
+			unsigned int rotations;		// offset of the first rotation in samples
+			unsigned int positions;		// offset of the first position in samples
+			unsigned int rotationStride;	// 1, or 0 for a rotation stored once
+			unsigned int positionStride;	// 1, or 0 for a position stored once
+		};
+
+		// three 16 bit values, a rotation or a position
+		struct Sample
+		{
+			unsigned short v[3];
+		};
+
+		const Header* header() const { return (const Header*)&blob[0]; }
+		const Track* tracks() const { return (const Track*)&blob[sizeof(Header)]; }
+		const Sample* samples() const { return (const Sample*)&blob[sizeof(Header) + sizeof(Track)*getTrackCount()]; }
+
+		static Sample packRotation(const Quaternion &q);
+		static Quaternion unpackRotation(const Sample &s);
+
+		std::vector<unsigned char> blob;		// Header, then Tracks, then Samples
+		AnimationBinding *binding;
+	};
+}
+
+#endif
@@ -0,0 +1,102 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// depthsorter.cpp
+//
+// Orders points far to near for alpha blending
+// Depths are packed with their index into a flat array and radix sorted on a 32 bit float key.
+// Optionally starts from the previous order, which is usually almost right, and only falls back
+// to the radix sort when that needs too many moves.
+
+#include "DepthSorter.h"
+#include "RadixSort.h"
+
+namespace T3D
+{
+	DepthSorter::DepthSorter(void)
+	{
+		coherent = false;
+		coherentSorts = 0;
+		skipCoherent = 0;
+	}
+
+	DepthSorter::~DepthSorter(void)
+	{
+	}
+
+	const unsigned int* DepthSorter::sortBackToFront(const float *x, const float *y, const float *z, int count,
+		const Vector3 &eye, const Vector3 &forward)
+	{
+		if (count <= 0) {
+			order.clear();
+			return NULL;
+		}
+
+		unsigned int previous = order.size();
+		items.resize(count);
+
+		bool tryPrevious = coherent && previous > 0 && skipCoherent == 0;
+		if (skipCoherent > 0) skipCoherent--;
+
+		if (tryPrevious) {
+			// Start from last frame's order.  Points are only ever removed from the end or swapped in
+			// from it, so dropping indices past the end and appending new ones keeps a permutation.
+			unsigned int n = 0;
+			for (unsigned int k = 0; k < previous; k++) {
+				uint32_t i = order[k];
+				if (i < (uint32_t)count) items[n++].index = i;
+			}
+			for (uint32_t i = previous; i < (uint32_t)count; i++)
+				items[n++].index = i;
+		}
+		else {
+			for (int i = 0; i < count; i++)
+				items[i].index = i;
+		}
+
+		// depth along the view direction, negated so ascending keys are far to near
+		for (int k = 0; k < count; k++) {
+			uint32_t i = items[k].index;
+			float depth = (x[i] - eye.x) * forward.x + (y[i] - eye.y) * forward.y + (z[i] - eye.z) * forward.z;
+			items[k].key = floatSortKey(-depth);
+		}
+
+		if (tryPrevious && insertionSort(4 * count)) {
+			coherentSorts++;
+		}
+		else {
+			if (tryPrevious) skipCoherent = RETRY_INTERVAL;
+			radixSort(items, buffer);
+		}
+
+		order.resize(count);
+		for (int k = 0; k < count; k++)
+			order[k] = items[k].index;
+		return &order[0];
+	}
+
+	/*! Sorts items in place, giving up once too many items have had to move
+	  \param maxMoves	Most single place moves allowed
+	  \return			true if the items are sorted, otherwise they are left partly sorted
+	  */
+	bool DepthSorter::insertionSort(unsigned int maxMoves)
+	{
+		unsigned int moves = 0;
+		size_t count = items.size();
+		for (size_t i = 1; i < count; i++) {
+			Item item = items[i];
+			size_t j = i;
+			while (j > 0 && items[j - 1].key > item.key) {
+				items[j] = items[j - 1];
+				j--;
+				if (++moves > maxMoves) {
+					items[j] = item;
+					return false;
+				}
+			}
+			items[j] = item;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,65 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// depthsorter.h
+//
+// Orders points far to near for alpha blending
+// Depths are packed with their index into a flat array and radix sorted on a 32 bit float key.
+// Optionally starts from the previous order, which is usually almost right, and only falls back
+// to the radix sort when that needs too many moves.
+
+#ifndef DEPTHSORTER_H
+#define DEPTHSORTER_H
+
+#include <vector>
+#include <stdint.h>
+#include "Vector3.h"
+
+namespace T3D
+{
+	class DepthSorter
+	{
+	public:
+		DepthSorter(void);
+		~DepthSorter(void);
+
+		//! Reuse the previous order as the starting point, for sets that change little between frames
+		//! If it turns out to be far from sorted the next few sorts go straight to the radix sort
+		void setCoherent(bool coherent){ this->coherent = coherent; }
+
+		/*! Orders points back to front along the view direction
+		  \param x, y, z	Point coordinates, count entries each
+		  \param count		Number of points
+		  \param eye		Viewer position
+		  \param forward	View direction (unit vector)
+		  \return			count point indices, farthest first, valid until the next call
+		  */
+		const unsigned int* sortBackToFront(const float *x, const float *y, const float *z, int count,
+			const Vector3 &eye, const Vector3 &forward);
+
+		//! Number of sorts the previous order was close enough to finish
+		unsigned int getCoherentSorts(){ return coherentSorts; }
+
+	private:
+		struct Item
+		{
+			uint32_t key;			// floatSortKey of the negated depth
+			uint32_t index;
+		};
+
+		bool insertionSort(unsigned int maxMoves);
+
+		std::vector<Item> items;
+		std::vector<Item> buffer;			// radix sort scratch
+		std::vector<unsigned int> order;	// result, and the starting point for the next sort
+		bool coherent;
+		unsigned int coherentSorts;
+		unsigned int skipCoherent;			// sorts left before trying the previous order again
+
+		static const unsigned int RETRY_INTERVAL = 16;	// sorts to skip after the previous order was too far out
+	};
+}
+
+#endif
+
@@ -0,0 +1,179 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// glinstancer.cpp
+//
+// Draws many copies of a mesh with one instanced call
+// A built in vertex shader reproduces the fixed function lighting, texture matrix and fog for
+// each copy, taking its world matrix and alpha from a streamed per instance buffer.  Needs
+// GLSL and the ARB_instanced_arrays and ARB_draw_instanced extensions.
+
+#include <gl\glew.h>
+#include <gl\GL.h>
+#include <iostream>
+#include <string.h>
+
+#include "GLInstancer.h"
+#include "GLStateCache.h"
+#include "GameObject.h"
+#include "Transform.h"
+
+namespace T3D
+{
+	// Fixed function per vertex lighting (no spot lights, infinite viewer) with the model
+	// matrix taken from the instance attributes.  There is no fragment shader so texturing
+	// and fog stay fixed function.
+	static const char *instanceVertexSource =
+		"#version 120\n"
+		"attribute vec4 instanceRow0;\n"
+		"attribute vec4 instanceRow1;\n"
+		"attribute vec4 instanceRow2;\n"
+		"attribute vec4 instanceRow3;\n"
+		"attribute float instanceAlpha;\n"
+		"uniform float lightEnabled[8];\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 world = vec4(dot(instanceRow0, gl_Vertex), dot(instanceRow1, gl_Vertex),\n"
+		"		dot(instanceRow2, gl_Vertex), dot(instanceRow3, gl_Vertex));\n"
+		"	vec3 worldNormal = vec3(dot(instanceRow0.xyz, gl_Normal), dot(instanceRow1.xyz, gl_Normal),\n"
+		"		dot(instanceRow2.xyz, gl_Normal));\n"
+		"	vec4 eye = gl_ModelViewMatrix * world;\n"
+		"	vec3 N = normalize(gl_NormalMatrix * worldNormal);\n"
+		"	vec4 colour = gl_FrontLightModelProduct.sceneColor;\n"
+		"	for (int i = 0; i < 8; i++) {\n"
+		"		if (lightEnabled[i] == 0.0) continue;\n"
+		"		vec3 L;\n"
+		"		float attenuation = 1.0;\n"
+		"		if (gl_LightSource[i].position.w == 0.0) {\n"
+		"			L = normalize(gl_LightSource[i].position.xyz);\n"
+		"		} else {\n"
+		"			vec3 d = gl_LightSource[i].position.xyz - eye.xyz;\n"
+		"			float dist = length(d);\n"
+		"			L = d / dist;\n"
+		"			attenuation = 1.0 / (gl_LightSource[i].constantAttenuation\n"
+		"				+ gl_LightSource[i].linearAttenuation * dist\n"
+		"				+ gl_LightSource[i].quadraticAttenuation * dist * dist);\n"
+		"		}\n"
+		"		float nDotL = max(dot(N, L), 0.0);\n"
+		"		vec4 lit = gl_FrontLightProduct[i].ambient + gl_FrontLightProduct[i].diffuse * nDotL;\n"
+		"		if (nDotL > 0.0) {\n"
+		"			vec3 H = normalize(L + vec3(0.0, 0.0, 1.0));\n"
+		"			lit += gl_FrontLightProduct[i].specular * pow(max(dot(N, H), 0.0), gl_FrontMaterial.shininess);\n"
+		"		}\n"
+		"		colour += attenuation * lit;\n"
+		"	}\n"
+		"	colour = clamp(colour, 0.0, 1.0);\n"
+		"	colour.a = instanceAlpha < 1.0 ? instanceAlpha : gl_FrontMaterial.diffuse.a;\n"
+		"	gl_FrontColor = colour;\n"
+		"	gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;\n"
+		"	gl_FogFragCoord = abs(eye.z);\n"
+		"	gl_Position = gl_ProjectionMatrix * eye;\n"
+		"}\n";
+
+	GLInstancer::GLInstancer(void)
+	{
+		supported = false;
+		program = 0;
+		vertexShader = 0;
+		lightEnabledLocation = -1;
+		for (int i = 0; i < MAX_LIGHTS; i++)
+			lightEnabled[i] = 0;
+		instanceBuffer = 0;
+		instanceBufferBytes = 0;
+	}
+
+	GLInstancer::~GLInstancer(void)
+	{
+		// GL objects go with the context
+	}
+
+	bool GLInstancer::init()
+	{
+		supported = false;
+		if (!GLEW_VERSION_2_0 || !GLEW_ARB_instanced_arrays || !GLEW_ARB_draw_instanced)
+			return false;
+
+		GLint result;
+		vertexShader = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(vertexShader, 1, &instanceVertexSource, NULL);
+		glCompileShader(vertexShader);
+		glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &result);
+		if (result != GL_TRUE) {
+			GLchar log[1024];
+			glGetShaderInfoLog(vertexShader, sizeof(log), NULL, log);
+			std::cout << "Instancing vertex shader did not compile, instancing disabled...\n" << log << "\n";
+			return false;
+		}
+
+		program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glBindAttribLocation(program, ROW_ATTRIBUTE, "instanceRow0");
+		glBindAttribLocation(program, ROW_ATTRIBUTE + 1, "instanceRow1");
+		glBindAttribLocation(program, ROW_ATTRIBUTE + 2, "instanceRow2");
+		glBindAttribLocation(program, ROW_ATTRIBUTE + 3, "instanceRow3");
+		glBindAttribLocation(program, ALPHA_ATTRIBUTE, "instanceAlpha");
+		glLinkProgram(program);
+		glGetProgramiv(program, GL_LINK_STATUS, &result);
+		if (result != GL_TRUE) {
+			std::cout << "Error linking instancing shader, instancing disabled...\n";
+			return false;
+		}
+
+		lightEnabledLocation = glGetUniformLocation(program, "lightEnabled");
+		glGenBuffers(1, &instanceBuffer);
+
+		supported = true;
+		return true;
+	}
+
+	void GLInstancer::setLightEnabled(int light, bool enabled)
+	{
+		if (light < MAX_LIGHTS)
+			lightEnabled[light] = enabled ? 1.0f : 0.0f;
+	}
+
+	void GLInstancer::draw(GameObject **objects, int count, int numTris, int numQuads,
+		const void *triIndices, const void *quadIndices, GLStateCache *state)
+	{
+		// gather matrices and alpha, world matrices may be computed here
+		instanceData.resize(count * INSTANCE_FLOATS);
+		float *data = &instanceData[0];
+		for (int i = 0; i < count; i++) {
+			memcpy(data, objects[i]->getTransform()->getWorldMatrix().getData(), 16 * sizeof(float));
+			data[16] = objects[i]->getAlpha();
+			data += INSTANCE_FLOATS;
+		}
+
+		// stream into the instance buffer, orphaning last draw's copy so the driver needn't wait for it
+		unsigned int bytes = count * INSTANCE_FLOATS * sizeof(float);
+		state->bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+		if (bytes > instanceBufferBytes)
+			instanceBufferBytes = bytes;
+		glBufferData(GL_ARRAY_BUFFER, instanceBufferBytes, NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, &instanceData[0]);
+
+		GLsizei stride = INSTANCE_FLOATS * sizeof(float);
+		for (int row = 0; row < 4; row++) {
+			GLuint attribute = ROW_ATTRIBUTE + row;
+			glVertexAttribPointer(attribute, 4, GL_FLOAT, GL_FALSE, stride, (char*)NULL + row * 4 * sizeof(float));
+			glVertexAttribDivisorARB(attribute, 1);
+			glEnableVertexAttribArray(attribute);
+		}
+		glVertexAttribPointer(ALPHA_ATTRIBUTE, 1, GL_FLOAT, GL_FALSE, stride, (char*)NULL + 16 * sizeof(float));
+		glVertexAttribDivisorARB(ALPHA_ATTRIBUTE, 1);
+		glEnableVertexAttribArray(ALPHA_ATTRIBUTE);
+
+		glUseProgram(program);
+		glUniform1fv(lightEnabledLocation, MAX_LIGHTS, lightEnabled);
+
+		if (numTris > 0)
+			glDrawElementsInstancedARB(GL_TRIANGLES, 3 * numTris, GL_UNSIGNED_INT, triIndices, count);
+		if (numQuads > 0)
+			glDrawElementsInstancedARB(GL_QUADS, 4 * numQuads, GL_UNSIGNED_INT, quadIndices, count);
+
+		glUseProgram(0);
+		for (int attribute = ROW_ATTRIBUTE; attribute <= ALPHA_ATTRIBUTE; attribute++)
+			glDisableVertexAttribArray(attribute);
+	}
+}
@@ -0,0 +1,67 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// glinstancer.h
+//
+// Draws many copies of a mesh with one instanced call
+// A built in vertex shader reproduces the fixed function lighting, texture matrix and fog for
+// each copy, taking its world matrix and alpha from a streamed per instance buffer.  Needs
+// GLSL and the ARB_instanced_arrays and ARB_draw_instanced extensions.
+
+#ifndef GLINSTANCER_H
+#define GLINSTANCER_H
+
+#include <vector>
+
+namespace T3D
+{
+	class GameObject;
+	class GLStateCache;
+
+	class GLInstancer
+	{
+	public:
+		static const int MAX_LIGHTS = 8;
+
+		GLInstancer(void);
+		~GLInstancer(void);
+
+		//! Compiles the shader if the driver supports instancing, needs a GL context
+		bool init();
+		bool isSupported(){ return supported; }
+
+		//! Mirrors glEnable(GL_LIGHTi), the shader can't read it
+		void setLightEnabled(int light, bool enabled);
+
+		/*! Draws the mesh currently set in the vertex, normal and texture coordinate arrays once per object
+		  \param objects		Objects sharing the mesh and material, their world matrices and alpha are used
+		  \param count			Number of objects
+		  \param numTris		Triangles in the mesh
+		  \param numQuads		Quads in the mesh
+		  \param triIndices		Triangle indices (offset into the bound index buffer, or client pointer)
+		  \param quadIndices	Quad indices, as for triIndices
+		  \param state			Renderer state cache, the instance buffer is bound through it
+		  */
+		void draw(GameObject **objects, int count, int numTris, int numQuads,
+			const void *triIndices, const void *quadIndices, GLStateCache *state);
+
+	private:
+		static const int INSTANCE_FLOATS = 17;		// row major world matrix, then alpha
+		static const int ROW_ATTRIBUTE = 10;		// first of four matrix row attributes, clear of the aliased fixed function ones
+		static const int ALPHA_ATTRIBUTE = 14;
+
+		bool supported;
+		unsigned int program;
+		unsigned int vertexShader;
+		int lightEnabledLocation;
+		float lightEnabled[MAX_LIGHTS];
+
+		unsigned int instanceBuffer;
+		unsigned int instanceBufferBytes;			// allocated size
+		std::vector<float> instanceData;			// staging for the buffer, kept between draws
+	};
+}
+
+#endif
+
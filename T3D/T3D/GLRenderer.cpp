@@ -15,25 +15,56 @@
 #include <gl\GL.h>
 #include <gl\GLU.h>
 #include <iostream>
+#include <algorithm>
+#include <stddef.h>
 
 #include "GLRenderer.h"
 #include "GameObject.h"
 #include "Camera.h"
 #include "Shader.h"
+#include "GLStateCache.h"
+#include "GLInstancer.h"
+#include "ParticleSystem.h"
+
+// byte offset into the bound buffer object, for the gl*Pointer and glDrawElements calls
+#define BUFFER_OFFSET(i) ((char *)NULL + (i))
 
 namespace T3D
 {
 	GLRenderer::GLRenderer(void)
 	{
+		meshBufferBudget = 256*1024*1024;
+		meshBufferBytes = 0;
+		frame = 0;
+		meshBuffersSupported = false;
+		meshBuffersChecked = false;
+		state = new GLStateCache();
+		instancer = new GLInstancer();
+		particleBuffer = 0;
+		particleBufferBytes = 0;
 	}
 
 	GLRenderer::~GLRenderer(void)
 	{
+		// The GL context may already be gone, so just detach the meshes, the buffers go with the context
+		for (unsigned int i = 0; i < residentMeshes.size(); i++) {
+			if (residentMeshes[i]->mesh != NULL)
+				residentMeshes[i]->mesh->setResidency(NULL);
+			delete residentMeshes[i];
+		}
+		delete state;
+		delete instancer;
 	}
 
 	void GLRenderer::prerender()
 	{
-		polys_last_frame = 0;
+		if (!meshBuffersChecked) {
+			meshBuffersSupported = GLEW_VERSION_1_5 != 0;
+			meshBuffersChecked = true;
+			instancer->init();
+		}
+		frame++;
+		releaseOrphanedMeshes();
 
 		// set up lighting
 		glEnable(GL_NORMALIZE);
@@ -43,6 +74,7 @@ namespace T3D
 		for(unsigned int i = 0; i < lights.size(); ++i)
 		{
 			int lightid = GL_LIGHT0+i;
+			instancer->setLightEnabled(i, lights[i]->enabled);
 			if (lights[i]->enabled){
 				glEnable(lightid);
 				
@@ -74,6 +106,8 @@ namespace T3D
 				glDisable(lightid);
 			}	
 		}
+		for (unsigned int i = lights.size(); i < GLInstancer::MAX_LIGHTS; ++i)
+			instancer->setLightEnabled(i, false);
 
 		// Clear back buffer and depth buffer before any drawing
 		glDepthMask(GL_TRUE);		// depth mask must be true to clear buffer
@@ -193,10 +227,21 @@ namespace T3D
 		glDisable(GL_BLEND);
 
 		glPointSize(3.0);
+
+		// everything above sets GL state directly
+		state->invalidate();
 	}
 
 	void GLRenderer::postrender()
 	{
+		// overlays draw from client memory
+		state->bindBuffer(GL_ARRAY_BUFFER, 0);
+		state->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+		state_calls_last_frame = state->getIssued();
+		state_calls_skipped_last_frame = state->getSkipped();
+		state->resetCounters();
+
 		showD2DOverlays();
 
 		SDL_GL_SwapBuffers();
@@ -228,53 +273,50 @@ namespace T3D
 
 	void GLRenderer::loadMaterial(Material* mat){
 		if (mat != NULL){
-			glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, mat->getDiffuse());
-			glMaterialfv(GL_FRONT, GL_SPECULAR, mat->getSpecular());
-			glMaterialfv(GL_FRONT, GL_EMISSION, mat->getEmissive());
-			glMaterialf(GL_FRONT,GL_SHININESS, mat->getShininess());
-			glShadeModel(mat->getSmoothShading() ? GL_SMOOTH : GL_FLAT);
-			glDepthMask(mat->getDisablDepth() ?  GL_FALSE : GL_TRUE);	// enable/disable depth buffer write
+			// only state that differs from the previous material reaches GL
+			state->setMaterial(GL_AMBIENT_AND_DIFFUSE, mat->getDiffuse());
+			state->setMaterial(GL_SPECULAR, mat->getSpecular());
+			state->setMaterial(GL_EMISSION, mat->getEmissive());
+			state->setShininess(mat->getShininess());
+			state->setShadeModel(mat->getSmoothShading() ? GL_SMOOTH : GL_FLAT);
+			state->setDepthMask(!mat->getDisablDepth());	// enable/disable depth buffer write
 
 			if (mat->getBlending() == Material::BLEND_NONE) {
-				glDisable(GL_BLEND);						// No Blending (although diffuse alpha will still be used)
+				state->setEnabled(GL_BLEND, false);			// No Blending (although diffuse alpha will still be used)
 
 				// enable "on/off" transparency ("cookie cutter alpha")
 				// This will only work for textures with an alpha channel (i.e. not bmp)
-				glAlphaFunc(GL_GREATER, 0.99f);
-				glEnable(GL_ALPHA_TEST);
+				state->setAlphaFunc(GL_GREATER, 0.99f);
+				state->setEnabled(GL_ALPHA_TEST, true);
 			} 
 			else {
-				glDisable(GL_ALPHA_TEST);
-				glEnable(GL_BLEND);						// Enable Blending
+				state->setEnabled(GL_ALPHA_TEST, false);
+				state->setEnabled(GL_BLEND, true);			// Enable Blending
 
 				// Material only supports a limited number of predefined blending modes
 				if (mat->getBlending() == Material::BLEND_ADD) {
 					// colors are added (values >1 are clipped to 1)
-					glBlendFunc(GL_ONE, GL_ONE);
+					state->setBlendFunc(GL_ONE, GL_ONE);
 				}
 				else if (mat->getBlending() == Material::BLEND_MULTIPLY) {
 					// colors are multiplied (values >1 are clipped to 1)
-					glBlendFunc(GL_ZERO, GL_SRC_COLOR);
+					state->setBlendFunc(GL_ZERO, GL_SRC_COLOR);
 				}
 				else {
 					// Assume Material::BLEND_DEFAULT
 					// transparency: alpha=0 - invisible, alpha=1 - no transparency
-					glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+					state->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 				}
 			}
 
 			if (mat->isTextured()){
-				glEnable(GL_TEXTURE_2D);
-				glBindTexture(GL_TEXTURE_2D,mat->getTexID());
-				glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-				glMatrixMode(GL_TEXTURE);
-				glLoadIdentity();
-				float s = mat->getTextureScale();
-				glScalef(s,s,s);
+				state->setEnabled(GL_TEXTURE_2D, true);
+				state->bindTexture(mat->getTexID());
+				state->setClientState(GL_TEXTURE_COORD_ARRAY, true);
+				state->setTextureScale(mat->getTextureScale());
 			}
 			else {
-				glDisable(GL_TEXTURE_2D);
+				state->setEnabled(GL_TEXTURE_2D, false);
 			}
 
 			Shader *shader = mat->getShader();
@@ -297,18 +339,22 @@ namespace T3D
 		Mesh *mesh = object->getMesh();
 		if (mesh != NULL){
 
-			float *matdiffuse = NULL;
+			Material *mat = object->getMaterial();
 			if (object->getAlpha() < 1.0)
 			{
 				// object override of material alpha
 				float diffuse[4] = { 1.0, 1.0, 1.0, object->getAlpha() };
-				if (object->getMaterial() != NULL) {
-					matdiffuse = object->getMaterial()->getDiffuse();
+				if (mat != NULL) {
+					float *matdiffuse = mat->getDiffuse();
 					diffuse[0] = matdiffuse[0];
 					diffuse[1] = matdiffuse[1];
 					diffuse[2] = matdiffuse[2];
 				}
-				glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, diffuse);
+				state->setMaterial(GL_AMBIENT_AND_DIFFUSE, diffuse);
+			}
+			else if (mat != NULL) {
+				// put back the material diffuse if the previous object overrode it (skipped otherwise)
+				state->setMaterial(GL_AMBIENT_AND_DIFFUSE, mat->getDiffuse());
 			}
 
 			glMatrixMode(GL_MODELVIEW);
@@ -316,24 +362,160 @@ namespace T3D
 			glMultTransposeMatrixf((object->getTransform()->getWorldMatrix()).getData());
 			drawMesh(mesh);
 			glPopMatrix();
+		}
+	}
+	
+	/*! Draws a run of objects sharing a mesh and material with one instanced call
+	  Falls back to drawing them one by one for short runs, materials with their own shader,
+	  point display or drivers without instancing.
+	  \param objects	The objects to draw
+	  \param count		Number of objects
+	  */
+	void GLRenderer::drawInstances(GameObject **objects, int count){
+		Mesh *mesh = objects[0]->getMesh();
+		Material *mat = objects[0]->getMaterial();
+		if (count < MIN_INSTANCES || !instancer->isSupported() || showPoints
+			|| mesh == NULL || mat == NULL || mat->getShader() != NULL) {
+			Renderer::drawInstances(objects, count);
+			return;
+		}
+
+		// per object alpha is applied by the instancing shader, put back the material diffuse
+		state->setMaterial(GL_AMBIENT_AND_DIFFUSE, mat->getDiffuse());
+
+		const void *triIndices, *quadIndices;
+		setMeshArrays(mesh, triIndices, quadIndices);
+		instancer->draw(objects, count, mesh->getNumTris(), mesh->getNumQuads(), triIndices, quadIndices, state);
 
-			if (matdiffuse != NULL)
-				glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, matdiffuse);	// restore material diffuse after alpha override
+		polys_last_frame += count * (mesh->getNumQuads() + mesh->getNumTris());
+	}
+
+	static inline void setParticleVertex(GLRenderer::ParticleVertex &v, float x, float y, float z,
+		float u, float t, const unsigned char *colour){
+		v.x = x; v.y = y; v.z = z;
+		v.u = u; v.v = t;
+		v.colour[0] = colour[0]; v.colour[1] = colour[1]; v.colour[2] = colour[2]; v.colour[3] = colour[3];
+	}
+
+	/*! Draws each live particle as a quad facing the camera, all in one call
+	  The quads are expanded into one vertex array which is streamed to the GPU each frame.  The
+	  particle alpha scales the material alpha through the vertex colour, as GameObject::setAlpha
+	  does for meshes.
+	  \param particles	The particle system to draw
+	  */
+	void GLRenderer::drawParticles(ParticleSystem *particles){
+		int count = particles->getCount();
+		if (count == 0 || camera == NULL) return;
+
+		// quad corners are offsets along the camera's right and up axes, facing back along its view
+		Matrix3x3 rot;
+		camera->gameObject->getTransform()->getWorldMatrix().extract3x3Matrix(rot);
+		const ParticleParams &params = particles->getParams();
+		bool varySize = !params.size.isConstant();
+		bool varyColour = !(params.red.isConstant() && params.green.isConstant() && params.blue.isConstant());
+
+		// constant curves are folded into the shared corner offsets and colour
+		float halfSize = particles->getScale() * 0.5f;
+		if (!varySize) halfSize *= params.size.getStart();
+		Vector3 right = rot.GetColumn(0) * halfSize;
+		Vector3 up = rot.GetColumn(1) * halfSize;
+		Vector3 normal = rot.GetColumn(2);
+		float ax = right.x + up.x, ay = right.y + up.y, az = right.z + up.z;		// to the top right corner
+		float bx = right.x - up.x, by = right.y - up.y, bz = right.z - up.z;		// to the bottom right corner
+
+		float diffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		Material *mat = particles->getMaterial();
+		if (mat != NULL) {
+			float *matdiffuse = mat->getDiffuse();
+			for (int c = 0; c < 4; c++) diffuse[c] = std::min(std::max(matdiffuse[c], 0.0f), 1.0f);
+		}
+		if (!varyColour) {
+			diffuse[0] *= std::min(std::max(params.red.getStart(), 0.0f), 1.0f);
+			diffuse[1] *= std::min(std::max(params.green.getStart(), 0.0f), 1.0f);
+			diffuse[2] *= std::min(std::max(params.blue.getStart(), 0.0f), 1.0f);
+		}
+		unsigned char colour[4];
+		colour[0] = (unsigned char)(diffuse[0] * 255.0f + 0.5f);
+		colour[1] = (unsigned char)(diffuse[1] * 255.0f + 0.5f);
+		colour[2] = (unsigned char)(diffuse[2] * 255.0f + 0.5f);
+		float alphaScale = diffuse[3] * 255.0f;
+
+		const float *x = particles->getX();
+		const float *y = particles->getY();
+		const float *z = particles->getZ();
+		const float *alpha = particles->getAlpha();
+		const float *age = particles->getAge();
+		const float *life = particles->getLife();
+
+		// blended particles go far to near, camera looks down its -z axis
+		const unsigned int *order = NULL;
+		if (mat != NULL && mat->getSortedDraw())
+			order = particles->sortBackToFront(camera->gameObject->getTransform()->getWorldPosition(), -normal);
+
+		// particles are in world space, the modelview is just the camera
+		particleVertices.resize(count * 4);
+		ParticleVertex *v = &particleVertices[0];
+		for (int k = 0; k < count; k++, v += 4) {
+			int i = order ? order[k] : k;
+			colour[3] = (unsigned char)(std::min(std::max(alpha[i], 0.0f), 1.0f) * alphaScale + 0.5f);
+
+			if (varySize || varyColour) {
+				float t = age[i] / life[i];
+				if (varyColour) {
+					colour[0] = (unsigned char)(std::min(std::max(params.red.evaluate(t), 0.0f), 1.0f) * diffuse[0] * 255.0f + 0.5f);
+					colour[1] = (unsigned char)(std::min(std::max(params.green.evaluate(t), 0.0f), 1.0f) * diffuse[1] * 255.0f + 0.5f);
+					colour[2] = (unsigned char)(std::min(std::max(params.blue.evaluate(t), 0.0f), 1.0f) * diffuse[2] * 255.0f + 0.5f);
+				}
+				float s = varySize ? params.size.evaluate(t) : 1.0f;
+				setParticleVertex(v[0], x[i] - ax * s, y[i] - ay * s, z[i] - az * s, 0, 0, colour);
+				setParticleVertex(v[1], x[i] + bx * s, y[i] + by * s, z[i] + bz * s, 1, 0, colour);
+				setParticleVertex(v[2], x[i] + ax * s, y[i] + ay * s, z[i] + az * s, 1, 1, colour);
+				setParticleVertex(v[3], x[i] - bx * s, y[i] - by * s, z[i] - bz * s, 0, 1, colour);
+				continue;
+			}
 
+			setParticleVertex(v[0], x[i] - ax, y[i] - ay, z[i] - az, 0, 0, colour);
+			setParticleVertex(v[1], x[i] + bx, y[i] + by, z[i] + bz, 1, 0, colour);
+			setParticleVertex(v[2], x[i] + ax, y[i] + ay, z[i] + az, 1, 1, colour);
+			setParticleVertex(v[3], x[i] - bx, y[i] - by, z[i] - bz, 0, 1, colour);
 		}
+
+		unsigned int bytes = count * 4 * sizeof(ParticleVertex);
+		const char *base;
+		if (meshBuffersSupported) {
+			if (particleBuffer == 0) glGenBuffers(1, &particleBuffer);
+			state->bindBuffer(GL_ARRAY_BUFFER, particleBuffer);
+			if (bytes > particleBufferBytes) particleBufferBytes = bytes;
+			// orphan last draw's copy so the driver needn't wait for it
+			glBufferData(GL_ARRAY_BUFFER, particleBufferBytes, NULL, GL_STREAM_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, &particleVertices[0]);
+			base = BUFFER_OFFSET(0);
+		}
+		else {
+			base = (const char *)&particleVertices[0];
+		}
+
+		state->setClientState(GL_VERTEX_ARRAY, true);
+		state->setClientState(GL_NORMAL_ARRAY, false);
+		state->setClientState(GL_COLOR_ARRAY, true);
+		glVertexPointer(3, GL_FLOAT, sizeof(ParticleVertex), base);
+		glTexCoordPointer(2, GL_FLOAT, sizeof(ParticleVertex), base + offsetof(ParticleVertex, u));
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ParticleVertex), base + offsetof(ParticleVertex, colour));
+		glNormal3f(normal.x, normal.y, normal.z);
+
+		state->setColorMaterial(true);
+		glDrawArrays(GL_QUADS, 0, count * 4);
+		state->setColorMaterial(false);
+		state->setClientState(GL_COLOR_ARRAY, false);
+
+		polys_last_frame += count;
 	}
-	
-	void GLRenderer::drawMesh(Mesh* mesh){
-		glEnableClientState(GL_VERTEX_ARRAY);
-		//glEnableClientState(GL_COLOR_ARRAY);
-		glEnableClientState(GL_NORMAL_ARRAY);
 
-		glVertexPointer(3,GL_FLOAT,0,mesh->getVertices());
-		glNormalPointer(GL_FLOAT,0,mesh->getNormals());
-		glTexCoordPointer(2, GL_FLOAT, 0, mesh->getUVs());
-		//glColorPointer(4,GL_FLOAT,0,mesh->getColors());
-		glDrawElements(GL_TRIANGLES,3*mesh->getNumTris(),GL_UNSIGNED_INT,mesh->getTriIndices());
-		glDrawElements(GL_QUADS, 4 * mesh->getNumQuads(), GL_UNSIGNED_INT, mesh->getQuadIndices());
+	void GLRenderer::drawMesh(Mesh* mesh){
+		const void *triIndices, *quadIndices;
+		setMeshArrays(mesh, triIndices, quadIndices);
+		glDrawElements(GL_TRIANGLES,3*mesh->getNumTris(),GL_UNSIGNED_INT,triIndices);
+		glDrawElements(GL_QUADS, 4 * mesh->getNumQuads(), GL_UNSIGNED_INT, quadIndices);
 
 		polys_last_frame += mesh->getNumQuads();
 		polys_last_frame += mesh->getNumTris();
@@ -341,6 +523,168 @@ namespace T3D
 		if (showPoints) glDrawArrays(GL_POINTS, 0, mesh->getNumVerts());
 	}
 
+	/*! Points the vertex, normal and texture coordinate arrays at a mesh
+	  \param mesh			The mesh to be drawn
+	  \param triIndices	Set to the triangle indices argument for glDrawElements
+	  \param quadIndices	Set to the quad indices argument for glDrawElements
+	  */
+	void GLRenderer::setMeshArrays(Mesh *mesh, const void *&triIndices, const void *&quadIndices){
+		state->setClientState(GL_VERTEX_ARRAY, true);
+		//state->setClientState(GL_COLOR_ARRAY, true);
+		state->setClientState(GL_NORMAL_ARRAY, true);
+
+		MeshResidency *r = meshBuffersSupported ? makeResident(mesh) : NULL;
+		if (r != NULL) {
+			// mesh is in GPU memory, pointers are offsets into the bound buffers
+			state->bindBuffer(GL_ARRAY_BUFFER, r->vertexBuffer);
+			state->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, r->indexBuffer);
+
+			glVertexPointer(3,GL_FLOAT,0,BUFFER_OFFSET(0));
+			glNormalPointer(GL_FLOAT,0,BUFFER_OFFSET(r->normalOffset));
+			glTexCoordPointer(2, GL_FLOAT, 0, BUFFER_OFFSET(r->uvOffset));
+			triIndices = BUFFER_OFFSET(0);
+			quadIndices = BUFFER_OFFSET(r->quadOffset);
+		}
+		else {
+			// no buffer objects or over budget, draw from client memory
+			if (meshBuffersSupported) {
+				state->bindBuffer(GL_ARRAY_BUFFER, 0);
+				state->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+			}
+
+			glVertexPointer(3,GL_FLOAT,0,mesh->getVertices());
+			glNormalPointer(GL_FLOAT,0,mesh->getNormals());
+			glTexCoordPointer(2, GL_FLOAT, 0, mesh->getUVs());
+			//glColorPointer(4,GL_FLOAT,0,mesh->getColors());
+			triIndices = mesh->getTriIndices();
+			quadIndices = mesh->getQuadIndices();
+		}
+	}
+
+	/*! Returns the GPU copy of a mesh, uploading it if it isn't resident or has changed
+	  \param mesh	The mesh about to be drawn
+	  \return		The residency record, or NULL if the mesh doesn't fit in the budget
+	  */
+	MeshResidency* GLRenderer::makeResident(Mesh *mesh){
+		MeshResidency *r = mesh->getResidency();
+
+		if (r == NULL) {
+			unsigned int vertexBytes = mesh->getNumVerts() * 3 * sizeof(float);
+			unsigned int normalBytes = mesh->getNormals() ? vertexBytes : 0;
+			unsigned int uvBytes = mesh->getUVs() ? mesh->getNumVerts() * 2 * sizeof(float) : 0;
+			unsigned int triBytes = mesh->getNumTris() * 3 * sizeof(unsigned int);
+			unsigned int quadBytes = mesh->getNumQuads() * 4 * sizeof(unsigned int);
+			unsigned int bytes = vertexBytes + normalBytes + uvBytes + triBytes + quadBytes;
+
+			if (meshBufferBytes + bytes > meshBufferBudget && !evictMeshes(bytes))
+				return NULL;
+
+			r = new MeshResidency();
+			r->mesh = mesh;
+			r->normalOffset = vertexBytes;
+			r->uvOffset = vertexBytes + normalBytes;
+			r->quadOffset = triBytes;
+			r->bytes = bytes;
+			glGenBuffers(1, &r->vertexBuffer);
+			glGenBuffers(1, &r->indexBuffer);
+
+			state->bindBuffer(GL_ARRAY_BUFFER, r->vertexBuffer);
+			glBufferData(GL_ARRAY_BUFFER, vertexBytes + normalBytes + uvBytes, NULL, GL_STATIC_DRAW);
+			state->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, r->indexBuffer);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, triBytes + quadBytes, NULL, GL_STATIC_DRAW);
+			uploadMesh(r);
+
+			mesh->setResidency(r);
+			residentMeshes.push_back(r);
+			meshBufferBytes += bytes;
+		}
+		else if (r->version != mesh->getVersion()) {
+			// mesh has been edited since it was uploaded (e.g. terrain), array sizes don't change
+			state->bindBuffer(GL_ARRAY_BUFFER, r->vertexBuffer);
+			state->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, r->indexBuffer);
+			uploadMesh(r);
+		}
+
+		r->lastUsed = frame;
+		return r;
+	}
+
+	/*! Copies the mesh arrays into its buffers, which must be bound
+	  \param r		Residency record for the mesh
+	  */
+	void GLRenderer::uploadMesh(MeshResidency *r){
+		Mesh *mesh = r->mesh;
+		unsigned int vertexBytes = r->normalOffset;
+		unsigned int triBytes = r->quadOffset;
+
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, mesh->getVertices());
+		if (mesh->getNormals())
+			glBufferSubData(GL_ARRAY_BUFFER, r->normalOffset, vertexBytes, mesh->getNormals());
+		if (mesh->getUVs())
+			glBufferSubData(GL_ARRAY_BUFFER, r->uvOffset, mesh->getNumVerts() * 2 * sizeof(float), mesh->getUVs());
+		if (mesh->getNumTris() > 0)
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, triBytes, mesh->getTriIndices());
+		if (mesh->getNumQuads() > 0)
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, r->quadOffset, mesh->getNumQuads() * 4 * sizeof(unsigned int), mesh->getQuadIndices());
+
+		r->version = mesh->getVersion();
+	}
+
+	struct MeshResidencyLastUsedCompare
+	{
+		bool operator()(const MeshResidency *r1, const MeshResidency *r2) const {
+			return r1->lastUsed < r2->lastUsed;
+		}
+	};
+
+	/*! Frees the least recently drawn meshes until there is room for a new one
+	  Meshes already drawn this frame are never evicted.
+	  \param bytes	Size of the mesh that needs to fit
+	  \return		true if there is now room
+	  */
+	bool GLRenderer::evictMeshes(unsigned int bytes){
+		if (bytes > meshBufferBudget) return false;
+
+		std::sort(residentMeshes.begin(), residentMeshes.end(), MeshResidencyLastUsedCompare());
+
+		unsigned int evicted = 0;
+		while (evicted < residentMeshes.size() && meshBufferBytes + bytes > meshBufferBudget
+			&& residentMeshes[evicted]->lastUsed != frame) {
+			releaseMesh(residentMeshes[evicted]);
+			evicted++;
+		}
+		residentMeshes.erase(residentMeshes.begin(), residentMeshes.begin() + evicted);
+
+		return meshBufferBytes + bytes <= meshBufferBudget;
+	}
+
+	/*! Deletes a mesh's buffers and residency record
+	  The caller is responsible for removing the record from residentMeshes
+	  */
+	void GLRenderer::releaseMesh(MeshResidency *r){
+		// deleting a bound buffer unbinds it, keep the state cache in step
+		state->bindBuffer(GL_ARRAY_BUFFER, 0);
+		state->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		glDeleteBuffers(1, &r->vertexBuffer);
+		glDeleteBuffers(1, &r->indexBuffer);
+		meshBufferBytes -= r->bytes;
+		if (r->mesh != NULL)
+			r->mesh->setResidency(NULL);
+		delete r;
+	}
+
+	//! Frees buffers belonging to meshes deleted since the last frame
+	void GLRenderer::releaseOrphanedMeshes(){
+		unsigned int kept = 0;
+		for (unsigned int i = 0; i < residentMeshes.size(); i++) {
+			if (residentMeshes[i]->mesh == NULL)
+				releaseMesh(residentMeshes[i]);
+			else
+				residentMeshes[kept++] = residentMeshes[i];
+		}
+		residentMeshes.resize(kept);
+	}
+
 
 	void GLRenderer::drawSkybox(){		
 		glMatrixMode(GL_TEXTURE);
@@ -15,10 +15,14 @@
 #define	WINDOW_HEIGHT		640
 
 #include <list>
+#include <vector>
 #include "renderer.h"
 
 namespace T3D
 {
+	class GLStateCache;
+	class GLInstancer;
+
 	// Entry for simple display of text on screen. This is intended for diagnostic type display only
 	// Messages are only displayed for current frame then deleted
 	// This would be better implemented as a proper GameObject within the scene but there is currently
@@ -42,6 +46,8 @@ namespace T3D
 		void setCamera(Camera *cam);
 
 		void draw(GameObject* object);
+		void drawInstances(GameObject **objects, int count);
+		void drawParticles(ParticleSystem *particles);
 		
 		void loadTexture(Texture *tex, bool repeat = false);
 		void reloadTexture(Texture *tex);
@@ -53,8 +59,18 @@ namespace T3D
 		void add2DOverlay(Texture *texture, int x, int y);		// 2D overlay (used for on screen diagnostic messages mainly)
 		void remove2DOverlay(Texture *texture);					// remove overlay
 
+		//! Limit on GPU memory used for mesh buffers, least recently drawn meshes are evicted to make room
+		void setMeshBufferBudget(unsigned int bytes){ meshBufferBudget = bytes; }
+		unsigned int getMeshBufferBytes(){ return meshBufferBytes; }	// GPU memory currently used by mesh buffers
+
+		//! Interleaved particle quad corner, as streamed by drawParticles
+		struct ParticleVertex
+		{
+			float x, y, z;
+			float u, v;
+			unsigned char colour[4];
+		};
 
-		unsigned int polys_last_frame = 0;
 	private:
 		void loadMaterial(Material* mat);
 		void unloadMaterial(Material* mat);
@@ -62,14 +78,37 @@ namespace T3D
 		int GLRenderer::getTextureFormat(Texture *tex);
 
 		void drawMesh(Mesh *mesh);
+		void setMeshArrays(Mesh *mesh, const void *&triIndices, const void *&quadIndices);
 		void drawSkybox();
 
+		MeshResidency* makeResident(Mesh *mesh);
+		void uploadMesh(MeshResidency *r);
+		bool evictMeshes(unsigned int bytes);
+		void releaseMesh(MeshResidency *r);
+		void releaseOrphanedMeshes();
+
 		void showD2DOverlays();
 		void drawText();
 		void draw2DMesh(overlay2D *overlay);
 
 		std::list<overlay2D *> overlays;
 
+		GLStateCache *state;				// skips redundant state changes while drawing
+		GLInstancer *instancer;				// draws runs of objects sharing a mesh in one call
+
+		static const int MIN_INSTANCES = 4;	// shorter runs are cheaper drawn one by one
+
+		std::vector<ParticleVertex> particleVertices;	// staging for the particle buffer, kept between draws
+		unsigned int particleBuffer;					// streamed particle quads, shared by all systems
+		unsigned int particleBufferBytes;
+
+		std::vector<MeshResidency*> residentMeshes;
+		unsigned int meshBufferBudget;
+		unsigned int meshBufferBytes;
+		unsigned int frame;
+		bool meshBuffersSupported;			// GL 1.5 buffer objects, checked on first prerender
+		bool meshBuffersChecked;
+
 	};
 }
 
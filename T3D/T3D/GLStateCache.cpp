@@ -0,0 +1,223 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// glstatecache.cpp
+//
+// Shadow copy of the OpenGL state set while drawing the render queue
+// Each setter only calls GL when the value differs from the last one set, and counts the
+// calls it skipped.  Call invalidate() after any code that changes GL state directly.
+
+#include <gl\glew.h>
+#include <gl\GL.h>
+
+#include "GLStateCache.h"
+
+namespace T3D
+{
+	GLStateCache::GLStateCache(void)
+	{
+		invalidate();
+		resetCounters();
+	}
+
+	GLStateCache::~GLStateCache(void)
+	{
+	}
+
+	void GLStateCache::invalidate()
+	{
+		for (int i = 0; i < CAP_COUNT; i++)
+			caps[i] = UNKNOWN;
+		for (int i = 0; i < CLIENT_ARRAY_COUNT; i++)
+			clientArrays[i] = UNKNOWN;
+		for (int i = 0; i < MATERIAL_PARAM_COUNT; i++)
+			materialKnown[i] = false;
+		shininessKnown = false;
+		colorMaterial = UNKNOWN;
+		shadeModel = 0;
+		depthMask = UNKNOWN;
+		blendSrc = blendDst = 0;
+		alphaFunc = 0;
+		texture2DKnown = false;
+		textureScaleKnown = false;
+		arrayBufferKnown = false;
+		elementBufferKnown = false;
+	}
+
+	// counts the call and returns true if GL needs to be called
+	bool GLStateCache::changed(bool same)
+	{
+		if (same) {
+			skipped++;
+			return false;
+		}
+		issued++;
+		return true;
+	}
+
+	void GLStateCache::setEnabled(GLenum cap, bool enabled)
+	{
+		int index;
+		switch (cap) {
+			case GL_BLEND: index = BLEND; break;
+			case GL_ALPHA_TEST: index = ALPHA_TEST; break;
+			case GL_TEXTURE_2D: index = TEXTURE_2D; break;
+			case GL_LIGHTING: index = LIGHTING; break;
+			case GL_DEPTH_TEST: index = DEPTH_TEST; break;
+			case GL_CULL_FACE: index = CULL_FACE; break;
+			case GL_FOG: index = FOG; break;
+			default: index = UNKNOWN; break;		// not tracked, always passed on
+		}
+
+		if (index != UNKNOWN) {
+			if (!changed(caps[index] == (int)enabled)) return;
+			caps[index] = enabled;
+		}
+		else {
+			issued++;
+		}
+
+		if (enabled) glEnable(cap);
+		else glDisable(cap);
+	}
+
+	void GLStateCache::setClientState(GLenum array, bool enabled)
+	{
+		int index;
+		switch (array) {
+			case GL_VERTEX_ARRAY: index = VERTEX_ARRAY; break;
+			case GL_NORMAL_ARRAY: index = NORMAL_ARRAY; break;
+			case GL_TEXTURE_COORD_ARRAY: index = TEXTURE_COORD_ARRAY; break;
+			case GL_COLOR_ARRAY: index = COLOR_ARRAY; break;
+			default: index = UNKNOWN; break;
+		}
+
+		if (index != UNKNOWN) {
+			if (!changed(clientArrays[index] == (int)enabled)) return;
+			clientArrays[index] = enabled;
+		}
+		else {
+			issued++;
+		}
+
+		if (enabled) glEnableClientState(array);
+		else glDisableClientState(array);
+	}
+
+	void GLStateCache::setMaterial(GLenum pname, const float *params)
+	{
+		int index;
+		switch (pname) {
+			case GL_AMBIENT_AND_DIFFUSE: index = AMBIENT_AND_DIFFUSE; break;
+			case GL_SPECULAR: index = SPECULAR; break;
+			case GL_EMISSION: index = EMISSION; break;
+			default:
+				issued++;
+				glMaterialfv(GL_FRONT, pname, params);
+				return;
+		}
+
+		float *current = material[index];
+		bool same = materialKnown[index] && current[0] == params[0] && current[1] == params[1]
+			&& current[2] == params[2] && current[3] == params[3];
+		if (!changed(same)) return;
+
+		for (int i = 0; i < 4; i++)
+			current[i] = params[i];
+		materialKnown[index] = true;
+		glMaterialfv(GL_FRONT, pname, params);
+	}
+
+	void GLStateCache::setShininess(float s)
+	{
+		if (!changed(shininessKnown && shininess == s)) return;
+		shininess = s;
+		shininessKnown = true;
+		glMaterialf(GL_FRONT, GL_SHININESS, s);
+	}
+
+	void GLStateCache::setColorMaterial(bool enabled)
+	{
+		if (!changed(colorMaterial == (int)enabled)) return;
+		colorMaterial = enabled;
+		if (enabled) {
+			glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
+			glEnable(GL_COLOR_MATERIAL);
+		}
+		else {
+			glDisable(GL_COLOR_MATERIAL);
+		}
+		// the material colour is left at whatever vertex colour was last used
+		materialKnown[AMBIENT_AND_DIFFUSE] = false;
+	}
+
+	void GLStateCache::setShadeModel(GLenum mode)
+	{
+		if (!changed(shadeModel == mode)) return;
+		shadeModel = mode;
+		glShadeModel(mode);
+	}
+
+	void GLStateCache::setDepthMask(bool write)
+	{
+		if (!changed(depthMask == (int)write)) return;
+		depthMask = write;
+		glDepthMask(write ? GL_TRUE : GL_FALSE);
+	}
+
+	void GLStateCache::setBlendFunc(GLenum src, GLenum dst)
+	{
+		if (!changed(blendSrc == src && blendDst == dst)) return;
+		blendSrc = src;
+		blendDst = dst;
+		glBlendFunc(src, dst);
+	}
+
+	void GLStateCache::setAlphaFunc(GLenum func, float ref)
+	{
+		if (!changed(alphaFunc == func && alphaRef == ref)) return;
+		alphaFunc = func;
+		alphaRef = ref;
+		glAlphaFunc(func, ref);
+	}
+
+	void GLStateCache::bindTexture(GLuint texture)
+	{
+		if (!changed(texture2DKnown && texture2D == texture)) return;
+		texture2D = texture;
+		texture2DKnown = true;
+		glBindTexture(GL_TEXTURE_2D, texture);
+	}
+
+	/*! Sets the texture matrix to a uniform scale
+	  Leaves the matrix mode as GL_TEXTURE if the matrix was changed
+	  */
+	void GLStateCache::setTextureScale(float scale)
+	{
+		if (!changed(textureScaleKnown && textureScale == scale)) return;
+		textureScale = scale;
+		textureScaleKnown = true;
+		glMatrixMode(GL_TEXTURE);
+		glLoadIdentity();
+		glScalef(scale, scale, scale);
+	}
+
+	void GLStateCache::bindBuffer(GLenum target, GLuint buffer)
+	{
+		if (target == GL_ARRAY_BUFFER) {
+			if (!changed(arrayBufferKnown && arrayBuffer == buffer)) return;
+			arrayBuffer = buffer;
+			arrayBufferKnown = true;
+		}
+		else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+			if (!changed(elementBufferKnown && elementBuffer == buffer)) return;
+			elementBuffer = buffer;
+			elementBufferKnown = true;
+		}
+		else {
+			issued++;
+		}
+		glBindBuffer(target, buffer);
+	}
+}
@@ -0,0 +1,80 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// glstatecache.h
+//
+// Shadow copy of the OpenGL state set while drawing the render queue
+// Each setter only calls GL when the value differs from the last one set, and counts the
+// calls it skipped.  Call invalidate() after any code that changes GL state directly.
+
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+#include <gl\glew.h>
+
+namespace T3D
+{
+	class GLStateCache
+	{
+	public:
+		GLStateCache(void);
+		~GLStateCache(void);
+
+		//! Forgets all cached values so the next call to each setter always reaches GL
+		void invalidate();
+
+		void setEnabled(GLenum cap, bool enabled);				// glEnable/glDisable
+		void setClientState(GLenum array, bool enabled);		// glEnableClientState/glDisableClientState
+
+		void setMaterial(GLenum pname, const float *params);	// glMaterialfv(GL_FRONT, ...), 4 components
+		void setShininess(float shininess);
+		void setColorMaterial(bool enabled);					// ambient and diffuse follow glColor / the colour array
+		void setShadeModel(GLenum mode);
+		void setDepthMask(bool write);
+		void setBlendFunc(GLenum src, GLenum dst);
+		void setAlphaFunc(GLenum func, float ref);
+
+		void bindTexture(GLuint texture);						// GL_TEXTURE_2D
+		void setTextureScale(float scale);						// texture matrix set to a uniform scale
+		void bindBuffer(GLenum target, GLuint buffer);			// GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+
+		//! Calls made to GL and calls skipped since resetCounters
+		unsigned int getIssued(){ return issued; }
+		unsigned int getSkipped(){ return skipped; }
+		void resetCounters(){ issued = 0; skipped = 0; }
+
+	private:
+		enum Cap { BLEND, ALPHA_TEST, TEXTURE_2D, LIGHTING, DEPTH_TEST, CULL_FACE, FOG, CAP_COUNT };
+		enum ClientArray { VERTEX_ARRAY, NORMAL_ARRAY, TEXTURE_COORD_ARRAY, COLOR_ARRAY, CLIENT_ARRAY_COUNT };
+		enum MaterialParam { AMBIENT_AND_DIFFUSE, SPECULAR, EMISSION, MATERIAL_PARAM_COUNT };
+		enum Known { UNKNOWN = -1 };
+
+		bool changed(bool same);
+
+		int caps[CAP_COUNT];						// 0 off, 1 on, UNKNOWN
+		int clientArrays[CLIENT_ARRAY_COUNT];
+		float material[MATERIAL_PARAM_COUNT][4];
+		bool materialKnown[MATERIAL_PARAM_COUNT];
+		float shininess;
+		bool shininessKnown;
+		int colorMaterial;
+		GLenum shadeModel;
+		int depthMask;
+		GLenum blendSrc, blendDst;
+		GLenum alphaFunc;
+		float alphaRef;
+		bool texture2DKnown;
+		GLuint texture2D;
+		float textureScale;
+		bool textureScaleKnown;
+		bool arrayBufferKnown, elementBufferKnown;
+		GLuint arrayBuffer, elementBuffer;
+
+		unsigned int issued;
+		unsigned int skipped;
+	};
+}
+
+#endif
+
@@ -27,6 +27,7 @@ namespace T3D
 		setTransform(new Transform());
 		camera = NULL;
 		mesh = NULL;
+		particleSystem = NULL;
 		material = NULL;
 		light = NULL;
 		visible = true;
@@ -41,7 +42,7 @@ namespace T3D
 	GameObject::~GameObject(void)
 	{
 		if (camera) delete camera;
-		if (mesh) delete mesh;
+		releaseMesh();
 		if (light) delete light; // TODO: should make sure that this is removed from renderer's list of lights
 
 		std::vector<Component*>::iterator ci;
@@ -124,14 +125,27 @@ namespace T3D
 	}
 	
 	/*! Attaches a Mesh to this game object
-	  Sets the mesh variable for this object and also the gameObject link for the Mesh
+	  Takes a reference to the mesh, so a new mesh is deleted with the game object while a shared one
+	  (e.g. from the MeshCache) lives until its last user is gone.  The Mesh's gameObject link is only
+	  set while this game object is its sole user, a shared Mesh has none.
 	  \param m		The Mesh
 	  \todo			Should the mesh also be added to the list of Component's?  If not, why is Mesh a Component?
 	  */
 	void GameObject::setMesh(Mesh *m){
+		m->addRef();
+		releaseMesh();
 		mesh = m;
-		mesh->gameObject = this;
-		mBoundingSphere = mesh->calculateBoundingSphere();
+		mesh->gameObject = mesh->getRefCount() == 1 ? this : NULL;
+		mBoundingSphere = mesh->getBoundingSphere();
+	}
+
+	// drops the reference to the mesh, clearing its link back here first
+	void GameObject::releaseMesh(){
+		if (mesh == NULL) return;
+		if (mesh->gameObject == this)
+			mesh->gameObject = NULL;
+		mesh->release();
+		mesh = NULL;
 	}
 
 	/*! Returns the Mesh
@@ -149,9 +163,11 @@ namespace T3D
 	void GameObject::addComponent(Component *component){
 		components.push_back(component);
 		component->init(this);
+		app->getComponentManager()->add(component);
 	}
 
 	/*! Update all Component's attached to this game object
+	  \remark	The application no longer calls this, components are updated by type through the ComponentManager
 	  \param dt		The time that has passed since the last update (in seconds)
 	  */
 	void GameObject::update(float dt){
@@ -166,4 +182,12 @@ namespace T3D
 	BoundingSphere GameObject::getBoundingSphere() const {
 		return mBoundingSphere;
 	}
+
+	/*! Sets the bounding sphere used for culling
+	  \param b		Bounding sphere in the object's local space
+	  */
+	void GameObject::setBoundingSphere(const BoundingSphere &b){
+		mBoundingSphere = b;
+		transform->setNeedBoundUpdate();
+	}
 }
@@ -24,6 +24,7 @@ namespace T3D
 	class Component;
 	class Camera;
 	class Light;
+	class ParticleSystem;
 
 	//! Generic class for all objects that exist in the world
 	/*! A GameObject's location is defined by the attached Transform.  The behaviour of a GameObject is customised by adding one or more Component's.  
@@ -52,6 +53,10 @@ namespace T3D
 		void setMesh(Mesh *m);
 		Mesh* getMesh();
 
+		// Particles drawn by this object instead of a mesh, not owned
+		void setParticleSystem(ParticleSystem *p){ particleSystem = p; }
+		ParticleSystem* getParticleSystem(){ return particleSystem; }
+
 		T3DApplication* getApp(){return app; }
 
 		void addComponent(Component *component);
@@ -67,6 +72,7 @@ namespace T3D
 		float getAlpha() { return alpha; }
 
 		BoundingSphere getBoundingSphere() const;
+		void setBoundingSphere(const BoundingSphere &b);		// for objects without a mesh whose extent changes
 
 	protected:
 		T3DApplication *app;
@@ -75,10 +81,13 @@ namespace T3D
 		Light* light;
 		Material* material;
 		Mesh* mesh;
+		ParticleSystem* particleSystem;
 		float alpha;			// override material alpha if < 1.0
 
 		BoundingSphere mBoundingSphere;
 	private:		
+		void releaseMesh();
+
 		std::vector<Component*> components;
 
 		bool visible;						// object drawn or not
@@ -0,0 +1,70 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// headlessapplication.cpp
+//
+// t3d application with no window, input or sound
+// Runs the full task, component, culling and render queue pipeline against a NullRenderer for a
+// fixed number of frames.  Subclasses build their scene in init() as they would for WinGLApplication.
+
+#include <iostream>
+
+#include "HeadlessApplication.h"
+#include "NullRenderer.h"
+#include "Transform.h"
+
+namespace T3D
+{
+	HeadlessApplication::HeadlessApplication(int frames, double frameTime)
+	{
+		this->frames = frames;
+		this->frameTime = frameTime;
+		framesRun = 0;
+		runTime = 0;
+
+		running = false;
+		renderer = new NullRenderer();
+		root = new Transform(NULL,"Root");
+	}
+
+	HeadlessApplication::~HeadlessApplication(void)
+	{
+		delete root;
+		root = NULL;
+		delete renderer;
+		renderer = NULL;
+	}
+
+	bool HeadlessApplication::init(){
+		return true;
+	}
+
+	int HeadlessApplication::run(void){
+		if (init() == false) {
+			std::cout << "HeadlessApplication: init failed\n";
+			return -1;
+		}
+		running = true;
+
+		framesRun = 0;
+		clock.reset();
+		while (running && framesRun < frames) {
+			jobSystem->resetScratch();
+
+			advance(frameTime);
+
+			renderFrame();
+			framesRun++;
+		}
+		runTime = clock.elapsed();
+
+		quit();
+
+		return 0;
+	}
+
+	void HeadlessApplication::quit(void){
+		running = false;
+	}
+}
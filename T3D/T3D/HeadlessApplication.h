@@ -0,0 +1,49 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// headlessapplication.h
+//
+// t3d application with no window, input or sound
+// Runs the full task, component, culling and render queue pipeline against a NullRenderer for a
+// fixed number of frames.  Subclasses build their scene in init() as they would for WinGLApplication.
+
+#ifndef HEADLESSAPPLICATION_H
+#define HEADLESSAPPLICATION_H
+
+#include "T3DApplication.h"
+
+namespace T3D
+{
+	class HeadlessApplication :
+		public T3DApplication
+	{
+	public:
+		/*! Constructor
+		  \param frames		number of frames run() will simulate and render
+		  \param frameTime	simulated seconds per frame, so results don't depend on machine speed
+		  */
+		HeadlessApplication(int frames = 1000, double frameTime = 1.0/60.0);
+		virtual ~HeadlessApplication(void);
+
+		bool init();
+		int run(void);
+		void quit(void);
+
+		void setFrames(int f){ frames = f; }
+		int getFrames(){ return frames; }
+		int getFramesRun(){ return framesRun; }
+
+		//! Wall clock seconds spent in the frame loop of the last run
+		double getRunTime(){ return runTime; }
+
+	protected:
+		int frames;
+		double frameTime;
+		int framesRun;
+		double runTime;
+	};
+}
+
+#endif
+
@@ -0,0 +1,346 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// jobsystem.cpp
+//
+// Work-stealing thread pool owned by the application
+// Supports parallel-for over index ranges, task graphs with dependencies and
+// per-worker scratch memory.  The calling thread always takes part as worker 0, and with a
+// single worker everything runs inline, in submission order, on the calling thread.
+
+#include <iostream>
+#include <algorithm>
+#include <queue>
+#include <stdlib.h>
+#include "JobSystem.h"
+
+#ifdef _MSC_VER
+#define T3D_THREAD_LOCAL __declspec(thread)
+#else
+#define T3D_THREAD_LOCAL __thread
+#endif
+
+namespace T3D
+{
+	// worker index of the current thread, threads outside the pool count as worker 0
+	static T3D_THREAD_LOCAL int currentWorker = 0;
+
+	// ------------------------------------------------------------------------------------
+	// ScratchAllocator
+
+	ScratchAllocator::ScratchAllocator(size_t blockSize) : blockSize(blockSize)
+	{
+		used = 0;
+		current = 0;
+		blocks.push_back((char*)malloc(blockSize));
+		blockSizes.push_back(blockSize);
+	}
+
+	ScratchAllocator::~ScratchAllocator(void)
+	{
+		for (unsigned int i = 0; i < blocks.size(); ++i)
+			free(blocks[i]);
+	}
+
+	void* ScratchAllocator::allocate(size_t bytes, size_t alignment)
+	{
+		for (;;)
+		{
+			size_t base = (size_t)blocks[current];
+			size_t offset = ((base + used + alignment - 1) & ~(alignment - 1)) - base;
+			if (offset + bytes <= blockSizes[current])
+			{
+				used = offset + bytes;
+				return blocks[current] + offset;
+			}
+
+			// move on to the next block, adding one big enough if there isn't one
+			current++;
+			used = 0;
+			if (current == blocks.size() || blockSizes[current] < bytes + alignment)
+			{
+				size_t size = std::max(blockSize, bytes + alignment);
+				blocks.insert(blocks.begin() + current, (char*)malloc(size));
+				blockSizes.insert(blockSizes.begin() + current, size);
+			}
+		}
+	}
+
+	void ScratchAllocator::reset()
+	{
+		used = 0;
+		current = 0;
+	}
+
+	// ------------------------------------------------------------------------------------
+	// JobGraph
+
+	int JobGraph::add(const Job &job)
+	{
+		Node n;
+		n.job = job;
+		n.dependencies = 0;
+		nodes.push_back(n);
+		return (int)nodes.size() - 1;
+	}
+
+	void JobGraph::addDependency(int job, int dependsOn)
+	{
+		nodes[dependsOn].successors.push_back(job);
+		nodes[job].dependencies++;
+	}
+
+	// ------------------------------------------------------------------------------------
+	// JobSystem
+
+	JobSystem::JobSystem(int workers)
+	{
+		workerCount = std::max(1, workers);
+		pending = 0;
+		quitting = false;
+
+		for (int i = 0; i < workerCount; ++i)
+		{
+			queues.push_back(new WorkerQueue());
+			scratch.push_back(new ScratchAllocator());
+		}
+
+		// worker 0 is whichever thread submits work
+		for (int i = 1; i < workerCount; ++i)
+		{
+			threads.push_back(std::thread(&JobSystem::workerLoop, this, i));
+		}
+	}
+
+	JobSystem::~JobSystem(void)
+	{
+		{
+			std::lock_guard<std::mutex> lk(sleepLock);
+			quitting = true;
+		}
+		wake.notify_all();
+		for (unsigned int i = 0; i < threads.size(); ++i)
+			threads[i].join();
+
+		for (int i = 0; i < workerCount; ++i)
+		{
+			delete queues[i];
+			delete scratch[i];
+		}
+	}
+
+	int JobSystem::getCurrentWorker()
+	{
+		return currentWorker;
+	}
+
+	void JobSystem::resetScratch()
+	{
+		for (int i = 0; i < workerCount; ++i)
+			scratch[i]->reset();
+	}
+
+	void JobSystem::push(int worker, const Task &task)
+	{
+		pending++;			// counted before it is visible so pop can never take it below zero
+		{
+			std::lock_guard<std::mutex> lk(queues[worker]->lock);
+			queues[worker]->tasks.push_back(task);
+		}
+		{
+			std::lock_guard<std::mutex> lk(sleepLock);		// so a worker about to sleep can't miss this
+		}
+		wake.notify_one();
+	}
+
+	bool JobSystem::pop(int worker, Task &task)
+	{
+		// own queue first, newest task (still warm in cache)
+		{
+			WorkerQueue *q = queues[worker];
+			std::lock_guard<std::mutex> lk(q->lock);
+			if (!q->tasks.empty())
+			{
+				task = q->tasks.back();
+				q->tasks.pop_back();
+				pending--;
+				return true;
+			}
+		}
+		// then steal the oldest task from someone else
+		for (int i = 1; i < workerCount; ++i)
+		{
+			WorkerQueue *q = queues[(worker + i) % workerCount];
+			std::lock_guard<std::mutex> lk(q->lock);
+			if (!q->tasks.empty())
+			{
+				task = q->tasks.front();
+				q->tasks.pop_front();
+				pending--;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void JobSystem::execute(Task &task, int worker)
+	{
+		task.job(worker);
+		if (task.counter)
+			(*task.counter)--;
+	}
+
+	// help out with queued work until the counter reaches zero
+	void JobSystem::wait(std::atomic<int> &counter, int worker)
+	{
+		while (counter > 0)
+		{
+			Task task;
+			if (pop(worker, task))
+				execute(task, worker);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::workerLoop(int worker)
+	{
+		currentWorker = worker;
+		for (;;)
+		{
+			Task task;
+			if (pop(worker, task))
+			{
+				execute(task, worker);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lk(sleepLock);
+			if (quitting) break;
+			if (pending <= 0)
+				wake.wait(lk);
+		}
+	}
+
+	void JobSystem::parallelFor(int count, int grainSize, const RangeJob &job)
+	{
+		if (count <= 0) return;
+
+		int worker = currentWorker;
+		if (grainSize <= 0)
+			grainSize = std::max(1, count / (workerCount * 4));
+
+		if (workerCount == 1 || count <= grainSize)
+		{
+			job(0, count, worker);
+			return;
+		}
+
+		int chunks = (count + grainSize - 1) / grainSize;
+		std::atomic<int> counter(chunks);
+
+		for (int c = 0; c < chunks; ++c)
+		{
+			int begin = c * grainSize;
+			int end = std::min(count, begin + grainSize);
+
+			Task task;
+			task.job = [&job, begin, end](int w) { job(begin, end, w); };
+			task.counter = &counter;
+			push(worker, task);
+		}
+
+		wait(counter, worker);
+	}
+
+	void JobSystem::run(JobGraph &graph)
+	{
+		int n = graph.size();
+		if (n == 0) return;
+
+		int worker = currentWorker;
+
+		// Kahn's algorithm gives both the single worker order and a cycle check
+		std::vector<int> remaining(n);
+		std::queue<int> ready;
+		for (int i = 0; i < n; ++i)
+		{
+			remaining[i] = graph.nodes[i].dependencies;
+			if (remaining[i] == 0) ready.push(i);
+		}
+
+		if (workerCount == 1)
+		{
+			int done = 0;
+			while (!ready.empty())
+			{
+				int i = ready.front();
+				ready.pop();
+				graph.nodes[i].job(worker);
+				done++;
+				for (unsigned int s = 0; s < graph.nodes[i].successors.size(); ++s)
+				{
+					int next = graph.nodes[i].successors[s];
+					if (--remaining[next] == 0) ready.push(next);
+				}
+			}
+			if (done != n)
+				std::cout << "JobSystem: job graph has a cycle, " << (n - done) << " jobs not run\n";
+			return;
+		}
+
+		// check for cycles first or waiting on the graph would never return
+		{
+			std::vector<int> check(remaining);
+			std::queue<int> q(ready);
+			int reachable = 0;
+			while (!q.empty())
+			{
+				int i = q.front();
+				q.pop();
+				reachable++;
+				for (unsigned int s = 0; s < graph.nodes[i].successors.size(); ++s)
+				{
+					if (--check[graph.nodes[i].successors[s]] == 0) q.push(graph.nodes[i].successors[s]);
+				}
+			}
+			if (reachable != n)
+			{
+				std::cout << "JobSystem: job graph has a cycle, not run\n";
+				return;
+			}
+		}
+
+		std::atomic<int> *deps = new std::atomic<int>[n];
+		for (int i = 0; i < n; ++i)
+			deps[i] = remaining[i];
+		std::atomic<int> counter(n);
+
+		while (!ready.empty())
+		{
+			runNode(graph, deps, &counter, ready.front(), worker);
+			ready.pop();
+		}
+
+		wait(counter, worker);
+		delete[] deps;
+	}
+
+	// queue a graph node whose dependencies are complete, releasing its successors when done
+	void JobSystem::runNode(JobGraph &graph, std::atomic<int> *remaining, std::atomic<int> *counter, int node, int worker)
+	{
+		Task task;
+		task.counter = counter;
+		task.job = [this, &graph, remaining, counter, node](int w) {
+			graph.nodes[node].job(w);
+			const std::vector<int> &successors = graph.nodes[node].successors;
+			for (unsigned int s = 0; s < successors.size(); ++s)
+			{
+				if (--remaining[successors[s]] == 0)
+					runNode(graph, remaining, counter, successors[s], w);
+			}
+		};
+		push(worker, task);
+	}
+}
@@ -0,0 +1,146 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// jobsystem.h
+//
+// Work-stealing thread pool owned by the application
+// Supports parallel-for over index ranges, task graphs with dependencies and
+// per-worker scratch memory.  The calling thread always takes part as worker 0, and with a
+// single worker everything runs inline, in submission order, on the calling thread.
+
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace T3D
+{
+	//! Linear allocator for short lived per-worker data, emptied once a frame
+	class ScratchAllocator
+	{
+	public:
+		ScratchAllocator(size_t blockSize = 256*1024);
+		virtual ~ScratchAllocator(void);
+
+		void* allocate(size_t bytes, size_t alignment = 16);
+		template <class T> T* allocate(size_t count) { return (T*)allocate(count*sizeof(T)); }
+
+		//! Makes all memory available again - pointers handed out before this are invalid
+		void reset();
+
+	private:
+		std::vector<char*> blocks;
+		std::vector<size_t> blockSizes;
+		size_t blockSize;
+		size_t used;					// bytes used in the current block
+		unsigned int current;			// index of the current block
+	};
+
+	//! A set of jobs and the order constraints between them, run with JobSystem::run
+	class JobGraph
+	{
+	public:
+		typedef std::function<void(int worker)> Job;
+
+		/*! Adds a job to the graph
+		  \param job		the work to do, passed the index of the worker running it
+		  \return			the job's index, used to add dependencies
+		  */
+		int add(const Job &job);
+
+		/*! Makes one job wait for another
+		  \param job		the job that has to wait
+		  \param dependsOn	the job that must finish first
+		  */
+		void addDependency(int job, int dependsOn);
+
+		void clear(){ nodes.clear(); }
+		int size() const { return (int)nodes.size(); }
+
+	private:
+		friend class JobSystem;
+
+		struct Node
+		{
+			Job job;
+			std::vector<int> successors;
+			int dependencies;
+		};
+		std::vector<Node> nodes;
+	};
+
+	class JobSystem
+	{
+	public:
+		typedef std::function<void(int worker)> Job;
+		typedef std::function<void(int begin, int end, int worker)> RangeJob;
+
+		/*! Creates the pool
+		  \param workers	total number of workers including the calling thread, at least 1
+		  */
+		JobSystem(int workers = 1);
+		virtual ~JobSystem(void);
+
+		int getWorkerCount() const { return workerCount; }
+
+		/*! Splits [0,count) into ranges of grainSize and runs them across the workers
+		  Returns once every range is done.  With one worker the whole range is run as a
+		  single call on the calling thread.
+		  \param count		number of items
+		  \param grainSize	items per range, <= 0 picks a size from the worker count
+		  \param job		called with [begin,end) and the worker index
+		  */
+		void parallelFor(int count, int grainSize, const RangeJob &job);
+
+		/*! Runs every job in the graph, respecting dependencies, and returns when all are done
+		  With one worker jobs run in order of their index whenever their dependencies allow
+		  */
+		void run(JobGraph &graph);
+
+		//! Index of the worker on the calling thread (0 for the main thread)
+		static int getCurrentWorker();
+
+		ScratchAllocator& getScratch(int worker){ return *scratch[worker]; }
+		void resetScratch();
+
+	private:
+		struct Task
+		{
+			Job job;
+			std::atomic<int> *counter;		// decremented when the task has run
+		};
+
+		struct WorkerQueue
+		{
+			std::mutex lock;
+			std::deque<Task> tasks;
+		};
+
+		void push(int worker, const Task &task);
+		bool pop(int worker, Task &task);
+		void execute(Task &task, int worker);
+		void wait(std::atomic<int> &counter, int worker);
+		void workerLoop(int worker);
+		void runNode(JobGraph &graph, std::atomic<int> *remaining, std::atomic<int> *counter, int node, int worker);
+
+		int workerCount;
+		std::vector<WorkerQueue*> queues;
+		std::vector<ScratchAllocator*> scratch;
+		std::vector<std::thread> threads;
+
+		std::atomic<int> pending;			// tasks sitting in queues
+		std::mutex sleepLock;
+		std::condition_variable wake;
+		bool quitting;
+	};
+}
+
+#endif
+
@@ -25,6 +25,7 @@ namespace T3D
 		~LookAtBehaviour(void);
 				
 		virtual void update(float dt);
+		virtual UpdateAccess getUpdateAccess() const { return ACCESS_READ_TRANSFORMS; }		// reads the target
 
 		Transform *target;
 	};
@@ -7,16 +7,62 @@
 // main.cpp
 //
 // Main entry point. Creates and runs a T3DApplication
+//
+// Run with -benchmark <scene> [count] [frames] [workers] [output] [-flat] to run a headless
+// benchmark scene instead, the results are written as JSON to output (benchmark.json).
+// -flat stores the scene graph matrices in a flattened TransformHierarchy.
 
 //#include "T3DTest.h"
 //#include "Tutorial1_Baseline.h"
 #include "Tutorial4.h"
 //#include "ShaderTest.h"
 //#include "GLTestApplication.h"
+#include <string.h>
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include "BenchmarkApplication.h"
 
 using namespace T3D;
 
+static int runBenchmark(int argc, char* argv[]){
+	// -flat may go anywhere after -benchmark, the rest are positional
+	bool flat = false;
+	int args = 0;
+	for (int i = 0; i < argc; i++) {
+		if (i > 1 && strcmp(argv[i], "-flat") == 0)
+			flat = true;
+		else
+			argv[args++] = argv[i];
+	}
+	argc = args;
+
+	if (argc < 3) {
+		std::cout << "usage: " << argv[0] << " -benchmark <scene> [count] [frames] [workers] [output] [-flat]\n";
+		std::cout << "scenes: " << BenchmarkApplication::getSceneNames() << "\n";
+		return -1;
+	}
+	int count = argc > 3 ? atoi(argv[3]) : 1000;
+	int frames = argc > 4 ? atoi(argv[4]) : 300;
+	int workers = argc > 5 ? atoi(argv[5]) : 1;
+	const char *output = argc > 6 ? argv[6] : "benchmark.json";
+
+	BenchmarkApplication *benchmark = new BenchmarkApplication(argv[2], count, frames, workers, flat);
+	int result = benchmark->run();
+	if (result == 0) {
+		std::ofstream file(output);
+		benchmark->writeReport(file);
+		benchmark->writeReport(std::cout);
+	}
+	delete benchmark;
+
+	return result;
+}
+
 int main(int argc, char* argv[]){
+	if (argc > 1 && strcmp(argv[1], "-benchmark") == 0)
+		return runBenchmark(argc, argv);
+
 	//T3DApplication *theApp = new T3DTest();
 //	T3DApplication *theApp = new Tutorial1_Baseline();
 	//T3DApplication *theApp = new Tutorial2();
@@ -11,8 +11,13 @@
 #include "material.h"
 
 namespace T3D{
+	unsigned int Material::nextID = 1;
+
 	Material::Material(void)
 	{
+		id = nextID++;
+		priority = -1;
+
 		setDiffuse(1,1,1,1);
 		setSpecular(1,1,1,1);
 		setEmissive(0,0,0,1);
@@ -32,6 +37,9 @@ namespace T3D{
 
 	Material::Material(float r, float g, float b, float a)
 	{
+		id = nextID++;
+		priority = -1;
+
 		setDiffuse(r,g,b,a);
 		setSpecular(1,1,1,1);
 		setEmissive(0,0,0,1);
@@ -41,6 +49,8 @@ namespace T3D{
 		texture = NULL;
 		textureScale = 1.0;
 
+		shader = NULL;
+
 		smooth = true;
 
 		sortedDraw = false;
@@ -12,7 +12,6 @@
 #define MATERIAL_H
 
 #include <vector>
-#include <queue>
 #include "Texture.h"
 #include "Shader.h"
 
@@ -52,8 +51,11 @@ namespace T3D
 		void setShader(Shader* s){ shader = s; }
 		Shader* getShader(){ return shader; }
 
-		void addToQueue(GameObject* gameObject){ renderQueue.push(gameObject); }
-		std::queue<GameObject*> &getQueue(){ return renderQueue; }
+		unsigned int getID(){ return id; }
+
+		//! Draw order, set by Renderer::createMaterial.  Materials with a negative priority are not drawn
+		void setPriority(int p){ priority = p; }
+		int getPriority(){ return priority; }
 
 		float* getDiffuse(){ return diffuse; }
 		float* getSpecular(){ return specular; }
@@ -85,7 +87,10 @@ namespace T3D
 		bool sortedDraw;		// requires depth sorting when drawn
 		bool disableDepth;		// disables depth buffer updating (will still read)
 
-		std::queue<GameObject*> renderQueue;
+		unsigned int id;		// unique, used to group objects by material when drawing
+		int priority;
+
+		static unsigned int nextID;
 	};
 }
 
@@ -10,6 +10,7 @@
 // Adapted from Ogre3D
 
 #include "Matrix4x4.h"
+#include "Quaternion.h"
 
 namespace T3D
 {
@@ -171,4 +172,36 @@ namespace T3D
             r20, r21, r22, r23,
               0,   0,   0,   1);
     }
+    //-----------------------------------------------------------------------
+    void Matrix4x4::makeTransform(const Vector3& position, const Vector3& scale, const Quaternion& orientation)
+    {
+        // Rotation matrix straight from the quaternion, scaled by 2/|q|^2 so that
+        // a slightly denormalised quaternion still gives a pure rotation
+        float x = orientation.v.x, y = orientation.v.y, z = orientation.v.z, w = orientation.s;
+        float n = x*x + y*y + z*z + w*w;
+        float k = (n > 0.0f) ? 2.0f/n : 0.0f;
+
+        float xx = x*x*k, yy = y*y*k, zz = z*z*k;
+        float xy = x*y*k, xz = x*z*k, yz = y*z*k;
+        float wx = w*x*k, wy = w*y*k, wz = w*z*k;
+
+        // Ordering: scale, then rotate, then translate
+        m[0][0] = (1.0f - (yy + zz)) * scale.x;
+        m[0][1] = (xy - wz) * scale.y;
+        m[0][2] = (xz + wy) * scale.z;
+        m[0][3] = position.x;
+
+        m[1][0] = (xy + wz) * scale.x;
+        m[1][1] = (1.0f - (xx + zz)) * scale.y;
+        m[1][2] = (yz - wx) * scale.z;
+        m[1][3] = position.y;
+
+        m[2][0] = (xz - wy) * scale.x;
+        m[2][1] = (yz + wx) * scale.y;
+        m[2][2] = (1.0f - (xx + yy)) * scale.z;
+        m[2][3] = position.z;
+
+        // No projection term
+        m[3][0] = 0; m[3][1] = 0; m[3][2] = 0; m[3][3] = 1;
+    }
 }
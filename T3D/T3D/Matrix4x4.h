@@ -21,6 +21,8 @@
 
 namespace T3D
 {
+	class Quaternion;
+
 	class Matrix4x4
 	{
     protected:
@@ -465,7 +467,7 @@ namespace T3D
             of orientation axes, scale does not affect size of translation, rotation and scaling are always
             centered on the origin.
         */
-        //void makeTransform(const Vector3& position, const Vector3& scale, const Quaternion& orientation);
+        void makeTransform(const Vector3& position, const Vector3& scale, const Quaternion& orientation);
 
         /** Building an inverse Matrix4x4 from orientation / scale / position.
         @remarks
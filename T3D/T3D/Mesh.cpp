@@ -16,9 +16,13 @@
 
 namespace T3D
 {
+	unsigned int Mesh::nextID = 1;
 
 	Mesh::Mesh(void)
 	{
+		id = nextID++;
+		boundingSphereVersion = 0;
+		boundingSphereValid = false;
 		vertices = NULL;
 		normals = NULL;
 		triIndices = NULL;
@@ -28,10 +32,14 @@ namespace T3D
 		numVerts = 0;
 		numTris = 0;
 		numQuads = 0;
+		version = 0;
+		residency = NULL;
 	}
 
 	Mesh::~Mesh(void)
 	{
+		if (residency) residency->mesh = NULL;		// renderer frees the buffers
+
 		if (vertices) delete []vertices;
 		if (triIndices) delete []triIndices;
 		if (quadIndices) delete []quadIndices;
@@ -44,6 +52,7 @@ namespace T3D
 		vertices[i*3] = x;
 		vertices[i*3+1] = y;
 		vertices[i*3+2] = z;
+		version++;
 	}
 	Vector3 Mesh::getVertex(int i) const{
 		return Vector3(vertices[i*3], vertices[i*3+1], vertices[i*3+2]);
@@ -53,6 +62,7 @@ namespace T3D
 		colors[i*4+1] = g;
 		colors[i*4+2] = b;
 		colors[i*4+3] = a;
+		version++;
 	}
 	Vector4 Mesh::getColor(int i){
 		return Vector4(colors[i*4], colors[i*4+1], colors[i*4+2], colors[i*4+3]);
@@ -61,16 +71,19 @@ namespace T3D
 		normals[i*3] = x;
 		normals[i*3+1] = y;
 		normals[i*3+2] = z;
+		version++;
 	}
 	void Mesh::setNormal(int i, Vector3 n){
 		normals[i*3] = n.x;
 		normals[i*3+1] = n.y;
 		normals[i*3+2] = n.z;
+		version++;
 	}
 	void Mesh::addNormal(int i, Vector3 n){
 		normals[i*3] += n.x;
 		normals[i*3+1] += n.y;
 		normals[i*3+2] += n.z;
+		version++;
 	}
 	Vector3 Mesh::getNormal(int i){
 		return Vector3(normals[i*3], normals[i*3+1], normals[i*3+2]);
@@ -79,17 +92,20 @@ namespace T3D
 		triIndices[i*3] = a;
 		triIndices[i*3+1] = b;
 		triIndices[i*3+2] = c;
+		version++;
 	}
 	void Mesh::setFace(int i, int a, int b, int c, int d){
 		quadIndices[i*4] = a;
 		quadIndices[i*4+1] = b;
 		quadIndices[i*4+2] = c;
 		quadIndices[i*4+3] = d;
+		version++;
 	}
 	
 	void Mesh::setUV(int i, float u, float v){
 		uvs[i*2] = u;
 		uvs[i*2+1] = v;
+		version++;
 	}
 
 	void Mesh::calcNormals(){
@@ -189,6 +205,15 @@ namespace T3D
 		}
 	}
 
+	BoundingSphere Mesh::getBoundingSphere() {
+		if (!boundingSphereValid || boundingSphereVersion != version) {
+			boundingSphere = calculateBoundingSphere();
+			boundingSphereVersion = version;
+			boundingSphereValid = true;
+		}
+		return boundingSphere;
+	}
+
 	BoundingSphere Mesh::calculateBoundingSphere() const {
 
 		//Degenerate case: mesh has no vertices.
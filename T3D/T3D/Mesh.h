@@ -15,10 +15,31 @@
 #include "Component.h"
 #include "Vector4.h"
 #include "BoundingSphere.h"
+#include "RefCounted.h"
 
 namespace T3D
 {
-	class Mesh : public Component
+	class Mesh;
+
+	//! A renderer's copy of a mesh in GPU memory
+	/*! Created and owned by the renderer.  Deleting the mesh only clears the mesh pointer, the
+	  renderer frees the buffers itself next frame.
+	  */
+	struct MeshResidency
+	{
+		Mesh *mesh;						// NULL once the mesh has been deleted
+		unsigned int version;			// mesh version held in the buffers
+		unsigned int vertexBuffer;		// vertices, then normals, then uvs
+		unsigned int indexBuffer;		// triangle indices, then quad indices
+		unsigned int normalOffset;		// byte offsets of each array within its buffer
+		unsigned int uvOffset;
+		unsigned int quadOffset;
+		unsigned int bytes;				// total size of both buffers
+		unsigned int lastUsed;			// frame the mesh was last drawn
+	};
+
+	//! Shared between game objects, GameObject::setMesh takes a reference and the game object's destructor releases it
+	class Mesh : public Component, public RefCounted
 	{
 	public:
 		Mesh(void);
@@ -78,8 +99,32 @@ namespace T3D
 
 		virtual BoundingSphere calculateBoundingSphere() const;
 
+		//! Bounding sphere from calculateBoundingSphere, only recalculated when the mesh changes
+		BoundingSphere getBoundingSphere();
+
+		//! Changes each time the mesh data is modified through the set methods
+		unsigned int getVersion() const{ return version; }
+
+		//! Call after writing directly to the arrays so renderers refresh their copies
+		void markChanged(){ version++; }
+
+		//! Unique, used to group objects sharing this mesh when drawing
+		unsigned int getID() const{ return id; }
+
+		MeshResidency* getResidency(){ return residency; }
+		void setResidency(MeshResidency *r){ residency = r; }
+
 	protected:
 		int numVerts, numTris, numQuads;
+		unsigned int version;
+		MeshResidency *residency;
+		unsigned int id;
+
+		BoundingSphere boundingSphere;
+		unsigned int boundingSphereVersion;		// version the bounding sphere was calculated for
+		bool boundingSphereValid;
+
+		static unsigned int nextID;
 
 		float *vertices;
 		float *normals;
@@ -0,0 +1,88 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// meshcache.cpp
+//
+// Shares generated meshes between game objects
+// Meshes are keyed by the generator and its parameters, so asking twice for the same sphere
+// returns the same mesh.  Shared meshes must not be modified.
+
+#include "MeshCache.h"
+#include "Sphere.h"
+#include "Cube.h"
+#include "PlaneMesh.h"
+
+namespace T3D
+{
+	MeshCache::MeshCache(void)
+	{
+	}
+
+	/*! Destructor
+	  Drops the cache's references, meshes still attached to game objects live on until they are deleted
+	  */
+	MeshCache::~MeshCache(void)
+	{
+		std::map<Key, Mesh*>::iterator it;
+		for (it = meshes.begin(); it != meshes.end(); it++)
+			it->second->release();
+	}
+
+	/*! Returns a shared sphere mesh, building it the first time
+	  \param radius		Sphere radius
+	  \param density	Number of segments around the equator
+	  */
+	Mesh* MeshCache::getSphere(float radius, int density){
+		Mesh *mesh = find(SPHERE, radius, density);
+		if (mesh == NULL)
+			mesh = add(SPHERE, radius, density, new Sphere(radius, density));
+		return mesh;
+	}
+
+	/*! Returns a shared cube mesh, building it the first time
+	  \param size		Half the edge length
+	  */
+	Mesh* MeshCache::getCube(float size){
+		Mesh *mesh = find(CUBE, size, 0);
+		if (mesh == NULL)
+			mesh = add(CUBE, size, 0, new Cube(size));
+		return mesh;
+	}
+
+	/*! Returns a shared unit plane mesh (in the XZ plane), building it the first time
+	  \param density	Number of quads along each side
+	  */
+	Mesh* MeshCache::getPlane(int density){
+		Mesh *mesh = find(PLANE, 0, density);
+		if (mesh == NULL)
+			mesh = add(PLANE, 0, density, new PlaneMesh(density));
+		return mesh;
+	}
+
+	void MeshCache::purge(){
+		std::map<Key, Mesh*>::iterator it = meshes.begin();
+		while (it != meshes.end()) {
+			if (it->second->getRefCount() == 1) {
+				it->second->release();
+				meshes.erase(it++);
+			}
+			else {
+				it++;
+			}
+		}
+	}
+
+	Mesh* MeshCache::find(MeshType type, float size, int density){
+		Key key = { type, size, density };
+		std::map<Key, Mesh*>::iterator it = meshes.find(key);
+		return it != meshes.end() ? it->second : NULL;
+	}
+
+	Mesh* MeshCache::add(MeshType type, float size, int density, Mesh *mesh){
+		Key key = { type, size, density };
+		mesh->addRef();
+		meshes[key] = mesh;
+		return mesh;
+	}
+}
@@ -0,0 +1,59 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// meshcache.h
+//
+// Shares generated meshes between game objects
+// Meshes are keyed by the generator and its parameters, so asking twice for the same sphere
+// returns the same mesh.  Shared meshes must not be modified.
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <map>
+
+namespace T3D
+{
+	class Mesh;
+
+	class MeshCache
+	{
+	public:
+		MeshCache(void);
+		~MeshCache(void);
+
+		Mesh* getSphere(float radius, int density = 8);
+		Mesh* getCube(float size);
+		Mesh* getPlane(int density);
+
+		//! Frees cached meshes that no game object is using
+		void purge();
+
+		unsigned int size(){ return meshes.size(); }
+
+	private:
+		enum MeshType { SPHERE, CUBE, PLANE };
+
+		struct Key
+		{
+			MeshType type;
+			float size;
+			int density;
+
+			bool operator<(const Key &k) const {
+				if (type != k.type) return type < k.type;
+				if (size != k.size) return size < k.size;
+				return density < k.density;
+			}
+		};
+
+		Mesh* find(MeshType type, float size, int density);
+		Mesh* add(MeshType type, float size, int density, Mesh *mesh);
+
+		std::map<Key, Mesh*> meshes;		// each holds a reference
+	};
+}
+
+#endif
+
@@ -0,0 +1,111 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// nullrenderer.cpp
+//
+// A renderer with no graphics API behind it
+// Runs the same culling and render queue code as the real renderers and counts what would have
+// been drawn, so engine CPU cost can be measured on machines without a display or GPU.
+
+#include "NullRenderer.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "Mesh.h"
+#include "Camera.h"
+#include "ParticleSystem.h"
+
+namespace T3D
+{
+	NullRenderer::NullRenderer(void)
+	{
+		nextTextureID = 1;
+	}
+
+	NullRenderer::~NullRenderer(void)
+	{
+	}
+
+	void NullRenderer::prerender()
+	{
+	}
+
+	void NullRenderer::postrender()
+	{
+	}
+
+	void NullRenderer::draw(GameObject* object)
+	{
+		// fetch the world matrix as the GL renderer would, it may be computed lazily here
+		Matrix4x4 world = object->getTransform()->getWorldMatrix();
+		(void)world;
+
+		Mesh *mesh = object->getMesh();
+		if (mesh != NULL)
+			drawMesh(mesh);
+	}
+
+	// blended particles are sorted as the GL renderer would
+	void NullRenderer::drawParticles(ParticleSystem *particles)
+	{
+		Material *mat = particles->getMaterial();
+		if (camera != NULL && mat != NULL && mat->getSortedDraw()) {
+			Transform *view = camera->gameObject->getTransform();
+			Matrix3x3 rot;
+			view->getWorldMatrix().extract3x3Matrix(rot);
+			particles->sortBackToFront(view->getWorldPosition(), -rot.GetColumn(2));
+		}
+		polys_last_frame += particles->getCount();
+	}
+
+	// textures just get a unique id so code checking for a loaded texture still works
+	void NullRenderer::loadTexture(Texture *tex, bool repeat)
+	{
+		if (tex->getID() == 0)
+			tex->setID(nextTextureID++);
+	}
+
+	void NullRenderer::reloadTexture(Texture *tex)
+	{
+	}
+
+	void NullRenderer::unloadTexture(Texture *tex)
+	{
+		tex->setID(0);
+	}
+
+	void NullRenderer::loadSkybox(std::string tex)
+	{
+	}
+
+	bool NullRenderer::exists2DOverlay(Texture *texture)
+	{
+		return false;
+	}
+
+	void NullRenderer::add2DOverlay(Texture *texture, int x, int y)
+	{
+	}
+
+	void NullRenderer::remove2DOverlay(Texture *texture)
+	{
+	}
+
+	void NullRenderer::loadMaterial(Material* mat)
+	{
+	}
+
+	void NullRenderer::unloadMaterial(Material* mat)
+	{
+	}
+
+	void NullRenderer::drawMesh(Mesh *mesh)
+	{
+		polys_last_frame += mesh->getNumQuads();
+		polys_last_frame += mesh->getNumTris();
+	}
+
+	void NullRenderer::drawSkybox()
+	{
+	}
+}
@@ -0,0 +1,53 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// nullrenderer.h
+//
+// A renderer with no graphics API behind it
+// Runs the same culling and render queue code as the real renderers and counts what would have
+// been drawn, so engine CPU cost can be measured on machines without a display or GPU.
+
+#ifndef NULLRENDERER_H
+#define NULLRENDERER_H
+
+#include "renderer.h"
+
+namespace T3D
+{
+	class NullRenderer :
+		public Renderer
+	{
+	public:
+		NullRenderer(void);
+		virtual ~NullRenderer(void);
+
+		void prerender();
+		void postrender();
+
+		void draw(GameObject* object);
+		void drawParticles(ParticleSystem *particles);
+
+		void loadTexture(Texture *tex, bool repeat = false);
+		void reloadTexture(Texture *tex);
+		void unloadTexture(Texture *tex);
+
+		void loadSkybox(std::string tex);
+
+		bool exists2DOverlay(Texture *texture);
+		void add2DOverlay(Texture *texture, int x, int y);
+		void remove2DOverlay(Texture *texture);
+
+	private:
+		void loadMaterial(Material* mat);
+		void unloadMaterial(Material* mat);
+
+		void drawMesh(Mesh *mesh);
+		void drawSkybox();
+
+		unsigned int nextTextureID;
+	};
+}
+
+#endif
+
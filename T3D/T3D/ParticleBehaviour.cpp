@@ -10,6 +10,7 @@
 
 
 #include "GameObject.h"
+#include "T3DApplication.h"
 #include "Math.h"
 #include "Quaternion.h"
 #include "Transform.h"
@@ -25,25 +26,12 @@ namespace T3D
 	ParticleBehaviour::ParticleBehaviour(ParticleEmitter *emitter, float lifeSpanMin, float lifeSpanMax)
 	{
 		this->emitter = emitter;
+		this->params = &emitter->getParams();
 		this->lifeSpanMin = lifeSpanMin;
 		this->lifeSpanMax = lifeSpanMax;
 
+		index = -1;
 		active = false;
-
-		startDistanceX = 0;
-		startDistanceY = 0;
-		startDistanceZ = 0;
-
-		dirBaseThetaY = 0.0f;
-		dirBaseThetaZ = 0.0f;
-		directionVar = 0.0f;
-		speedStartMin = 0.0f;
-		speedStartMax = 0.0f;
-		acceleration = 0.0f;
-		speedMinMax = 0.0f;
-
-		alphaStart = 1.0f;
-		alphaEnd = 1.0f;
 	}
 
 
@@ -60,17 +48,17 @@ namespace T3D
 		// Derive world position from gameObject of parent ParticleEmitter
 		// Note the particle may or may not be a descendent of the particle emitter
 		Vector3 position = from->getTransform()->getWorldPosition();
-		position.x += Math::randRangeND(-startDistanceX, startDistanceX);
-		position.y += Math::randRangeND(-startDistanceY, startDistanceY);
-		position.z += Math::randRangeND(-startDistanceZ, startDistanceZ);
+		position.x += Math::randRangeND(-params->startDistanceX, params->startDistanceX);
+		position.y += Math::randRangeND(-params->startDistanceY, params->startDistanceY);
+		position.z += Math::randRangeND(-params->startDistanceZ, params->startDistanceZ);
 		this->gameObject->getTransform()->setWorldPosition(position);
 
-		Quaternion rotQ(0.0f, dirBaseThetaY + Math::randRange(-directionVar, directionVar), 
-							 dirBaseThetaZ + Math::randRange(-directionVar, directionVar));
+		Quaternion rotQ(0.0f, params->dirBaseThetaY + Math::randRange(-params->directionVar, params->directionVar), 
+							 params->dirBaseThetaZ + Math::randRange(-params->directionVar, params->directionVar));
 		Matrix3x3 rotM = (Matrix3x3)rotQ;
 		Vector3 unitX(1.0, 0.0, 0.0);
 		direction = unitX * rotM;
-		speed = Math::randRangeND(speedStartMin, speedStartMax);
+		speed = Math::randRangeND(params->speedStartMin, params->speedStartMax);
 
 				//rotationMatrix = (Matrix3x3)q;
 
@@ -83,8 +71,16 @@ namespace T3D
 							accelBase.z + Math::randRangeND(-accelVar.z, accelVar.z));
 							*/
 
+		if (!params->size.isConstant()) {
+			float size = params->scale * params->size.evaluate(0);
+			gameObject->getTransform()->setLocalScale(Vector3(size, size, size));
+		}
+
 		gameObject->setVisible(true);
 		active = true;
+
+		// picked up by the component manager next frame if it is part way through an update
+		gameObject->getApp()->getComponentManager()->add(this);
 	}
 
 	/*! stop
@@ -94,72 +90,13 @@ namespace T3D
 	{
 		gameObject->setVisible(false);
 		active = false;
+		// inactive particles are not visited at all until they are started again
+		gameObject->getApp()->getComponentManager()->remove(this);
 		// notify parent this particle is no longer active
 		emitter->addInactiveList(this);
 	}
 
 
-	/*! setPositionRange
-	  set initial maximum random distance from emitter
-	  \param dx		maximum initial distance from particle emitter in X axis (+/-)
-	  \param dy		maximum initial distance from particle emitter in Y axis (+/-)
-	  \param dz		maximum initial distance from particle emitter in Z axis (+/-)
-	  */
-	void ParticleBehaviour::setPositionRange(float dx, float dy, float dz)
-	{
-		this->startDistanceX = dx; 
-		this->startDistanceY = dy; 
-		this->startDistanceZ = dz; 
-	}
-
-	/*! setDirection
-	  Sets base direction of motion and random variance
-	  Assumes bases direction is along +ve x axis
-	  \param theta_y	rotation around y axis
-	  \param theta_z	rotation around z axis
-	  \param variance	+/- random variation applied to angles
-	  */
-	void ParticleBehaviour::setDirection(float theta_y, float theta_z, float variance)
-	{
-		this->dirBaseThetaY = theta_y;
-		this->dirBaseThetaZ = theta_z;
-		this->directionVar = variance;
-	}
-
-	/*! setStartVelocity
-	  Sets startup seed range
-	  \param min		min start speed (units per second)
-	  \param max		max start speed
-	  */
-	void ParticleBehaviour::setStartVelocity(float min, float max)
-	{
-		this->speedStartMin = min;
-		this->speedStartMax = max;
-	}
-
-	/*! setAcceleration
-	  Sets particles acceleration and min or max speed
-	  \param acceleration	particle acceleration (units per second per second)
-	  \param speedMinax		min speed if -ve acceleration otherwise max speed
-	  */
-	void ParticleBehaviour::setAcceleration(float acceleration, float speedMinMax)
-	{
-		this->acceleration = acceleration;
-		this->speedMinMax = speedMinMax;
-	}
-
-	/*! setAlphaFade
-	  Sets alpha blending (fade) gradient from start to end
-	  of article lifecycle.
-	  \param start		start alpha value (1.0 opaque, 0.0 invisible) 
-	  \param max		end alpha value
-	  */
-	void ParticleBehaviour::setAlphaFade(float start, float end)
-	{
-		alphaStart = start;
-		alphaEnd = end;
-	}
-
 	/*! update
 	  regular update
 	  \param dt		elapsed time from last frame 
@@ -171,29 +108,37 @@ namespace T3D
 		Vector3 position;
 		Vector3 velocity;
 
-		if (active)
+		dt = emitter->getParticleStep(dt);
+		if (active && dt > 0)
 		{
 
 			elapsed += dt;
 
 			if (elapsed < lifeSpan) {
+				float t = elapsed / lifeSpan;		// fraction of lifetime
 
 				// Apply motion (velocity and acceleration)
 				Vector3 position = this->gameObject->getTransform()->getLocalPosition();
+				float acceleration = params->acceleration;
 				speed += acceleration * dt;
 				// min speed if decelerating, max speed if accelerating
-				if ((acceleration < 0.0f && speed < speedMinMax) || (acceleration > 0.0f && speed > speedMinMax)) {
-					speed = speedMinMax;		// speed limit reached
+				if ((acceleration < 0.0f && speed < params->speedMinMax) || (acceleration > 0.0f && speed > params->speedMinMax)) {
+					speed = params->speedMinMax;		// speed limit reached
 				}
-				velocity = direction * speed;
+				velocity = direction * (speed * params->speed.evaluate(t));
 				position += velocity * dt;
 
 				this->gameObject->getTransform()->setLocalPosition(position);
 
-				// interpolate alpha blending value
-				alpha = alphaEnd + (lifeSpan - elapsed) / lifeSpan * (alphaStart - alphaEnd);
+				// alpha blending value and size from the emitter's curves
+				alpha = params->alpha.evaluate(t);
 				this->gameObject->setAlpha(alpha);
 
+				if (!params->size.isConstant()) {
+					float size = params->scale * params->size.evaluate(t);
+					this->gameObject->getTransform()->setLocalScale(Vector3(size, size, size));
+				}
+
 			}
 			else
 			{
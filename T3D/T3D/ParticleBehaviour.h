@@ -12,6 +12,7 @@
 #define PARTICLEBEHAVIOUR_H
 
 #include "Component.h"
+#include "ParticleParams.h"
 
 namespace T3D
 {
@@ -29,21 +30,19 @@ namespace T3D
 		ParticleBehaviour(ParticleEmitter *emitter, float lifeSpanMin, float lifeSpanMax);
 
 		virtual void start(GameObject *from);			// start or restart particle
-		void stop();									// stop and hide particle
+		void stop();									// stop and hide particle, which is then no longer updated
 		bool isActive() { return active; }
-
-		void setPositionRange(float dx, float dy, float dz);
-
-		void setDirection(float theta_y, float theta_z, float variance);
-		void setStartVelocity(float min, float max);
-		void setAcceleration(float acceleration, float speedMinMax);
-
-		void setAlphaFade(float start, float end);
+		int getIndex() const { return index; }			// position in the emitter's particle list
 
 		void update(float dt);
+		virtual UpdateAccess getUpdateAccess() const { return ACCESS_OWN_TRANSFORM; }
 
 	protected:
+		friend class ParticleEmitter;
+
 		ParticleEmitter *emitter;
+		int index;
+		const ParticleParams *params;	// shared settings, owned by the emitter
 
 		// Current state variables
 		bool active;			// particle is alive and active				
@@ -57,22 +56,6 @@ namespace T3D
 		float lifeSpanMin;		// minimum lifetime of active particle
 		float lifeSpanMax;		// maximum lifetime of active particle
 
-		float startDistanceX;	// maximum start distance from emitter in X axis
-		float startDistanceY;	// maximum start distance from emitter in Y axis
-		float startDistanceZ;	// maximum start distance from emitter in Z axis
-
-		float dirBaseThetaY;	// base direction rotation around Y axis
-		float dirBaseThetaZ;	// base direction rotation around Z axis
-		float directionVar;		// +/- random variability to direction theta Y,Z
-
-		float speedStartMin;	// start speed min (units per second)
-		float speedStartMax;	// start speed max (speed random between min and max)
-		float acceleration;		// acceleration (units per second per second)
-		float speedMinMax;		// min or max speed (based on ve of acceleration)
-
-		float alphaStart;		// alpha at start of lifecycle
-		float alphaEnd;			// alpha at end of sequence
-
 	};
 
 }
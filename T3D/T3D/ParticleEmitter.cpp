@@ -11,6 +11,7 @@
 // ParticleBehaviour component.
 
 #include <stdlib.h>
+#include <algorithm>
 
 #include "Math.h"
 #include "GameObject.h"
@@ -21,6 +22,7 @@
 #include "ParticleBehaviour.h"
 #include "Camera.h"
 #include "Billboard.h"
+#include "BoundingSphere.h"
 
 
 namespace T3D
@@ -51,6 +53,17 @@ namespace T3D
 		this->endEmitRate = endEmitRate;
 		this->emitVariability = emitVariability;
 
+		lodEnabled = false;
+		lodFullDistance = 0;
+		lodMaxDistance = 0;
+		lodMaxTickDivisor = 1;
+		lodViewRadius = 0;
+		lodTicks = 0;
+		lodTime = 0;
+		lodStep = -1.0f;
+		emitScale = 1.0f;
+		emitCarry = 0;
+
 	}
 
 	/*! Destructor
@@ -72,6 +85,7 @@ namespace T3D
 	  */
 	void ParticleEmitter::addParticle(ParticleBehaviour *particle, bool start)
 	{
+		particle->index = (int)particles.size();
 		particles.push_back(particle);
 
 		if (start) {
@@ -90,7 +104,26 @@ namespace T3D
 	  */
 	void ParticleEmitter::addInactiveList(ParticleBehaviour *particle)
 	{
-		particlesInactive.push(particle);
+		std::lock_guard<std::mutex> lk(inactiveLock);
+		particlesStopped.push_back(particle);
+	}
+
+	static bool lowerIndex(const ParticleBehaviour *a, const ParticleBehaviour *b)
+	{
+		return a->getIndex() < b->getIndex();
+	}
+
+	/*! collectStopped
+	  Moves the particles stopped since the last emit to the inactive queue
+	  Particles stop on whichever worker updates them, so they are queued in index order to reuse
+	  them in the same order whatever the thread timing.
+	  */
+	void ParticleEmitter::collectStopped()
+	{
+		std::sort(particlesStopped.begin(), particlesStopped.end(), lowerIndex);
+		for (unsigned int i = 0; i < particlesStopped.size(); i++)
+			particlesInactive.push(particlesStopped[i]);
+		particlesStopped.clear();
 	}
 
 	/*! createBillboardParticles
@@ -105,6 +138,7 @@ namespace T3D
 	void ParticleEmitter::createBillboardParticles(int n, float lifeSpanMin, float lifeSpanMax, Material *material, float scale, Transform *parent)
 	{
 		Transform *cameraTransform = this->gameObject->getApp()->getRenderer()->camera->gameObject->getTransform();
+		params.scale = scale;
 
 		for (int i=0; i<n; i++)
 		{
@@ -134,10 +168,9 @@ namespace T3D
 	  */
 	void ParticleEmitter::setPositionRange(float dx, float dy, float dz)
 	{
-		for (unsigned int i=0; i<particles.size(); i++)
-		{
-			particles[i]->setPositionRange(dx, dy, dz);
-		}
+		params.startDistanceX = dx;
+		params.startDistanceY = dy;
+		params.startDistanceZ = dz;
 	}
 
 	/*! setDirection
@@ -149,10 +182,9 @@ namespace T3D
 	  */
 	void ParticleEmitter::setDirection(float theta_y, float theta_z, float variance)
 	{
-		for (unsigned int i=0; i<particles.size(); i++)
-		{
-			particles[i]->setDirection(theta_y, theta_z, variance);
-		}
+		params.dirBaseThetaY = theta_y;
+		params.dirBaseThetaZ = theta_z;
+		params.directionVar = variance;
 	}
 
 	/*! setStartVelocity
@@ -162,10 +194,8 @@ namespace T3D
 	  */
 	void ParticleEmitter::setStartVelocity(float min, float max)
 	{
-		for (unsigned int i=0; i<particles.size(); i++)
-		{
-			particles[i]->setStartVelocity(min, max);
-		}
+		params.speedStartMin = min;
+		params.speedStartMax = max;
 	}
 
 	/*! setAcceleration
@@ -175,10 +205,8 @@ namespace T3D
 	  */
 	void ParticleEmitter::setAcceleration(float acceleration, float speedMinMax)
 	{
-		for (unsigned int i=0; i<particles.size(); i++)
-		{
-			particles[i]->setAcceleration(acceleration, speedMinMax);
-		}
+		params.acceleration = acceleration;
+		params.speedMinMax = speedMinMax;
 	}
 
 	/*! setAlphaFade
@@ -189,10 +217,21 @@ namespace T3D
 	  */
 	void ParticleEmitter::setAlphaFade(float start, float end)
 	{
-		for (unsigned int i=0; i<particles.size(); i++)
-		{
-			particles[i]->setAlphaFade(start, end);
-		}
+		params.alpha = ParticleCurve(start, end);
+	}
+
+	/*! setColourCurve
+	  Sets curves over the particle lifetime that multiply the material colour
+	  Only ParticleSystem particles can change colour, billboard particles share their material
+	  \param red		red multiplier
+	  \param green		green multiplier
+	  \param blue		blue multiplier
+	  */
+	void ParticleEmitter::setColourCurve(const ParticleCurve &red, const ParticleCurve &green, const ParticleCurve &blue)
+	{
+		params.red = red;
+		params.green = green;
+		params.blue = blue;
 	}
 
 
@@ -209,7 +248,7 @@ namespace T3D
 			for (unsigned int i=0; i<particles.size(); i++)
 			{
 				// stop any active particles
-				if (!particles[i]->isActive())
+				if (particles[i]->isActive())
 					particles[i]->stop();	// note this will add particle to particlesInactive
 			}
 		}
@@ -225,6 +264,7 @@ namespace T3D
 	{
 		ParticleBehaviour *particle;
 
+		collectStopped();
 		while (n > 0 && !particlesInactive.empty())
 		{
 			particle = particlesInactive.front();
@@ -246,6 +286,9 @@ namespace T3D
 		float count;
 		std::list<ParticleBehaviour *>::iterator i;
 
+		dt = updateLOD(dt);
+		if (dt <= 0) return;
+
 		elapsed += dt;			// total particle system run time
 
 		if (elapsed < (rampUpDuration + runDuration + rampDownDuration))
@@ -263,8 +306,73 @@ namespace T3D
 			// been generated by this time in the particles systems life. 
 			count -= emitted;	// minus the number already emitted to give how many we need to emit now
 
-			emit((int)(count + 0.5f), true);			// emit rounded up output count
+			if (emitScale >= 1.0f) {
+				emit((int)(count + 0.5f), true);			// emit rounded up output count
+			}
+			else if (count > 0) {
+				// the skipped particles still count as emitted, so there is no burst when scaling stops
+				int n = (int)(count + 0.5f);
+				float scaled = n * emitScale + emitCarry;
+				emit((int)scaled, false);
+				emitCarry = scaled - (int)scaled;
+				emitted += n;
+			}
+		}
+	}
+
+	void ParticleEmitter::setLOD(float fullDistance, float maxDistance, int maxTickDivisor, float viewRadius)
+	{
+		lodEnabled = true;
+		lodFullDistance = fullDistance;
+		lodMaxDistance = std::max(maxDistance, fullDistance);
+		lodMaxTickDivisor = std::max(maxTickDivisor, 1);
+		lodViewRadius = viewRadius;
+	}
+
+	/*! updateLOD
+	  Works out this update's emission scale and particle time from the camera
+	  The view test uses the frustum of the last rendered frame, a frame late.
+	  \param dt	time since the last update
+	  \return		time for the emitter to advance, 0 to skip this update
+	  */
+	float ParticleEmitter::updateLOD(float dt)
+	{
+		lodStep = -1.0f;
+		emitScale = 1.0f;
+
+		Camera *camera = gameObject->getApp()->getRenderer()->camera;
+		if (!lodEnabled || camera == NULL) return dt;
+
+		Vector3 position = gameObject->getTransform()->getWorldPosition();
+		float distance = (position - camera->gameObject->getTransform()->getWorldPosition()).length();
+
+		// frozen, the time is dropped rather than caught up later
+		bool visible = lodViewRadius <= 0 ||
+			camera->contains(BoundingSphere::create(position, lodViewRadius)) != Camera::None;
+		if (distance > lodMaxDistance || !visible) {
+			lodTicks = 0;
+			lodTime = 0;
+			lodStep = 0;
+			return 0;
 		}
+
+		float t = 0;
+		if (distance > lodFullDistance)
+			t = (distance - lodFullDistance) / (lodMaxDistance - lodFullDistance);
+		emitScale = 1.0f - t;
+
+		// particles and emission move in bigger steps when updated less often
+		lodTime += dt;
+		int divisor = 1 + (int)((lodMaxTickDivisor - 1) * t + 0.5f);
+		if (++lodTicks < divisor) {
+			lodStep = 0;
+			return 0;
+		}
+
+		lodStep = lodTime;
+		lodTicks = 0;
+		lodTime = 0;
+		return lodStep;
 	}
 
 	/*! emitRamp
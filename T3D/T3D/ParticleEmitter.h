@@ -13,8 +13,10 @@
 
 #include <list>
 #include <queue>
+#include <mutex>
 #include "Component.h"
 #include "ParticleBehaviour.h"
+#include "ParticleParams.h"
 
 
 namespace T3D
@@ -36,27 +38,54 @@ namespace T3D
 		void addParticle(ParticleBehaviour *particle, bool start);	/// add particle for use
 		void createBillboardParticles(int n, float lifeSpanMin, float lifeSpanMax, Material *material, float scale, Transform *parent); 
 
-		// particle attributes
+		// particle attributes, shared by all particles so each is a single write
 		void setPositionRange(float dx, float dy, float dz);
 		void setDirection(float theta_y, float theta_z, float variance);
 		void setStartVelocity(float min, float max);
 		void setAcceleration(float acceleration, float speedMinMax);
 		void setAlphaFade(float start, float end);
 
+		// values over each particle's lifetime
+		void setAlphaCurve(const ParticleCurve &alpha){ params.alpha = alpha; }
+		void setSizeCurve(const ParticleCurve &size){ params.size = size; }
+		void setSpeedCurve(const ParticleCurve &speed){ params.speed = speed; }
+		void setColourCurve(const ParticleCurve &red, const ParticleCurve &green, const ParticleCurve &blue);
+
+		const ParticleParams& getParams() const { return params; }
+
+
+		/*! Level of detail by distance from the renderer's camera
+		  Emission falls linearly from full rate at fullDistance to none at maxDistance, and
+		  particles are updated less often, down to once every maxTickDivisor updates.  Beyond
+		  maxDistance, or outside the last rendered view, the emitter and its particles are frozen.
+		  \param fullDistance		full detail within this distance
+		  \param maxDistance		suspended beyond this distance
+		  \param maxTickDivisor	updates per particle update at maxDistance
+		  \param viewRadius		how far particles reach from the emitter, 0 to ignore the view
+		  */
+		void setLOD(float fullDistance, float maxDistance, int maxTickDivisor = 4, float viewRadius = 0.0f);
+		void clearLOD() { lodEnabled = false; lodStep = -1.0f; }
+
+		//! Time particles should advance this update, 0 while they are skipped or suspended
+		float getParticleStep(float dt) const { return lodStep < 0 ? dt : lodStep; }
 
 		void windDown() { elapsed = rampUpDuration + runDuration; }
 		void restart() { elapsed = 0; emitted = 0; }
-		void stop(bool clear);
-		void emit(int n, bool count=false);
-		void update(float dt);
+		virtual void stop(bool clear);
+		virtual void emit(int n, bool count=false);
+		virtual void update(float dt);
 
 
-	private:
+	protected:
 		float emitRamp(float start, float end, float duration, float time, float variability);
+		float updateLOD(float dt);
+		void collectStopped();
 
-	protected:
+		ParticleParams params;								// settings for all particles
 		std::vector<ParticleBehaviour *> particles;			// all particles
 		std::queue<ParticleBehaviour *> particlesInactive;	// inactive particles that can be started
+		std::vector<ParticleBehaviour *> particlesStopped;	// stopped since the last emit, in any order
+		std::mutex inactiveLock;							// particles may stop from several worker threads
 
 		float elapsed;					//elapsed system time
 		int emitted;					//number of particles emitted during run
@@ -68,6 +97,18 @@ namespace T3D
 		float rampDownDuration;
 		float endEmitRate;
 		float emitVariability;			// random variability in emit rate (+/- fraction)
+
+		// level of detail
+		bool lodEnabled;
+		float lodFullDistance;
+		float lodMaxDistance;
+		int lodMaxTickDivisor;
+		float lodViewRadius;
+		int lodTicks;					// updates since the particles were last updated
+		float lodTime;					// time those updates covered
+		float lodStep;					// this update's particle time, -1 without LOD
+		float emitScale;				// fraction of the emission curve to emit
+		float emitCarry;				// fractional particles owed by the scaling
 	
 	};
 
@@ -0,0 +1,91 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming
+// =========================================================================================
+//
+// ParticleParams.cpp
+//
+// Particle settings shared by all particles of an emitter
+// Held once by the emitter and read by its particles, so changing a setting is one write no
+// matter how many particles are live.  Curves vary a value over each particle's lifetime.
+
+#include <iostream>
+#include "ParticleParams.h"
+
+namespace T3D
+{
+	ParticleCurve::ParticleCurve(float value)
+	{
+		clear(value);
+	}
+
+	ParticleCurve::ParticleCurve(float start, float end)
+	{
+		clear(start);
+		times[1] = 1.0f;
+		values[1] = end;
+		keys = 2;
+	}
+
+	void ParticleCurve::clear(float value)
+	{
+		keys = 1;
+		times[0] = 0.0f;
+		values[0] = value;
+	}
+
+	void ParticleCurve::addKey(float time, float value)
+	{
+		// a key at time 0 replaces the starting value
+		if (time <= 0.0f && keys == 1) {
+			values[0] = value;
+			return;
+		}
+
+		if (keys == MAX_KEYS) {
+			std::cout << "ParticleCurve: too many keys, " << MAX_KEYS << " is the limit\n";
+			return;
+		}
+
+		times[keys] = time;
+		values[keys] = value;
+		keys++;
+	}
+
+	float ParticleCurve::evaluate(float t) const
+	{
+		if (t <= times[0]) return values[0];
+
+		for (int k = 1; k < keys; k++) {
+			if (t < times[k]) {
+				float f = (t - times[k - 1]) / (times[k] - times[k - 1]);
+				return values[k - 1] + (values[k] - values[k - 1]) * f;
+			}
+		}
+		return values[keys - 1];
+	}
+
+	float ParticleCurve::getMax() const
+	{
+		float max = values[0];
+		for (int k = 1; k < keys; k++)
+			if (values[k] > max) max = values[k];
+		return max;
+	}
+
+	ParticleParams::ParticleParams()
+	{
+		startDistanceX = 0;
+		startDistanceY = 0;
+		startDistanceZ = 0;
+
+		dirBaseThetaY = 0.0f;
+		dirBaseThetaZ = 0.0f;
+		directionVar = 0.0f;
+		speedStartMin = 0.0f;
+		speedStartMax = 0.0f;
+		acceleration = 0.0f;
+		speedMinMax = 0.0f;
+
+		scale = 1.0f;
+	}
+}
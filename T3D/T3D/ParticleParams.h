@@ -0,0 +1,78 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming
+// =========================================================================================
+//
+// ParticleParams.h
+//
+// Particle settings shared by all particles of an emitter
+// Held once by the emitter and read by its particles, so changing a setting is one write no
+// matter how many particles are live.  Curves vary a value over each particle's lifetime.
+
+#ifndef PARTICLEPARAMS_H
+#define PARTICLEPARAMS_H
+
+namespace T3D
+{
+	//! Piecewise linear value over a particle's lifetime (0 at birth, 1 at death)
+	class ParticleCurve
+	{
+	public:
+		static const int MAX_KEYS = 8;
+
+		ParticleCurve(float value = 1.0f);			// constant
+		ParticleCurve(float start, float end);		// straight line from start to end
+
+		//! Replaces the curve with a constant
+		void clear(float value);
+
+		/*! Adds a key, keys must be added in time order
+		  \param time		lifetime fraction, 0 to 1
+		  \param value		value at that time
+		  */
+		void addKey(float time, float value);
+
+		float evaluate(float t) const;
+
+		bool isConstant() const { return keys == 1; }
+		//! A straight line from time 0 to 1 (or constant), which can be evaluated as start + (end - start) * t
+		bool isLinear() const { return keys == 1 || (keys == 2 && times[0] == 0.0f && times[1] == 1.0f); }
+		float getStart() const { return values[0]; }
+		float getEnd() const { return values[keys - 1]; }
+		float getMax() const;
+
+	private:
+		int keys;
+		float times[MAX_KEYS];
+		float values[MAX_KEYS];
+	};
+
+	//! Settings for every particle of an emitter
+	struct ParticleParams
+	{
+		ParticleParams();
+
+		float startDistanceX;	// maximum start distance from emitter in X axis
+		float startDistanceY;	// maximum start distance from emitter in Y axis
+		float startDistanceZ;	// maximum start distance from emitter in Z axis
+
+		float dirBaseThetaY;	// base direction rotation around Y axis
+		float dirBaseThetaZ;	// base direction rotation around Z axis
+		float directionVar;		// +/- random variability to direction theta Y,Z
+
+		float speedStartMin;	// start speed min (units per second)
+		float speedStartMax;	// start speed max (speed random between min and max)
+		float acceleration;		// acceleration (units per second per second)
+		float speedMinMax;		// min or max speed (based on ve of acceleration)
+
+		float scale;			// particle size
+
+		ParticleCurve alpha;	// alpha over lifetime
+		ParticleCurve size;		// multiplies scale
+		ParticleCurve speed;	// multiplies the accelerated speed
+		ParticleCurve red;		// multiply the material colour (ParticleSystem only)
+		ParticleCurve green;
+		ParticleCurve blue;
+	};
+}
+
+#endif //PARTICLEPARAMS_H
@@ -0,0 +1,379 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming
+// =========================================================================================
+//
+// ParticleSystem.cpp
+//
+// Particle emitter that simulates its particles itself
+// Particles are plain values in structure of arrays form rather than game objects, so a
+// system can run hundreds of thousands of them.  Uses the ParticleEmitter emission curve.
+
+#include <algorithm>
+#include <float.h>
+
+#include "Math.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "Quaternion.h"
+#include "T3DApplication.h"
+#include "Terrain.h"
+#include "ParticleSystem.h"
+#include "Simd.h"
+
+namespace T3D
+{
+	/*! Constructor
+	  Same emission curve as ParticleEmitter, particles are allocated by createParticles
+	  */
+	ParticleSystem::ParticleSystem(float rampUpDuration, float startEmitRate,
+		float runDuration, float emitRate, float rampDownDuration, float endEmitRate, float emitVariability)
+		: ParticleEmitter(rampUpDuration, startEmitRate, runDuration, emitRate, rampDownDuration, endEmitRate, emitVariability)
+	{
+		count = 0;
+		capacity = 0;
+		renderObject = NULL;
+		rangeCount = 0;
+		terrain = NULL;
+		collisionMode = COLLIDE_NONE;
+		restitution = 0.5f;
+
+		lifeSpanMin = 1.0f;
+		lifeSpanMax = 1.0f;
+
+		sorter.setCoherent(true);		// particles move little between frames
+	}
+
+	ParticleSystem::~ParticleSystem()
+	{
+		// NOTE: delete gameObjects by deleting their Transform
+		if (renderObject) delete renderObject->getTransform();
+	}
+
+	void ParticleSystem::createParticles(int n, float lifeSpanMin, float lifeSpanMax, Material *material, float scale, Transform *parent)
+	{
+		capacity = n;
+		count = 0;
+		this->lifeSpanMin = lifeSpanMin;
+		this->lifeSpanMax = lifeSpanMax;
+		params.scale = scale;
+
+		x.resize(n); y.resize(n); z.resize(n);
+		dx.resize(n); dy.resize(n); dz.resize(n);
+		speed.resize(n);
+		age.resize(n);
+		life.resize(n);
+		alpha.resize(n);
+
+		if (renderObject == NULL) {
+			renderObject = new GameObject(gameObject->getApp());
+			renderObject->setParticleSystem(this);
+			renderObject->getTransform()->setParent(parent);
+			renderObject->getTransform()->name = "particles";
+		}
+		renderObject->setMaterial(material);
+		renderObject->setVisible(false);
+	}
+
+	Material* ParticleSystem::getMaterial()
+	{
+		return renderObject ? renderObject->getMaterial() : NULL;
+	}
+
+	void ParticleSystem::setTerrainCollision(Terrain *terrain, CollisionMode mode, float restitution)
+	{
+		this->terrain = terrain;
+		this->collisionMode = mode;
+		this->restitution = restitution;
+	}
+
+	const unsigned int* ParticleSystem::sortBackToFront(const Vector3 &eye, const Vector3 &forward)
+	{
+		return sorter.sortBackToFront(getX(), getY(), getZ(), count, eye, forward);
+	}
+
+	/*! stop
+	  Stop emitting
+	  \param clear	also remove all live particles
+	  */
+	void ParticleSystem::stop(bool clear)
+	{
+		ParticleEmitter::stop(false);
+		if (clear) {
+			count = 0;
+			rangeCount = 0;
+			updateBounds();
+		}
+	}
+
+	/*! emit
+	  Starts up to n particles at the emitter, fewer if the system is full
+	  \param n		number of particles to emit
+	  \param count	add to total emitted count
+	  */
+	void ParticleSystem::emit(int n, bool count)
+	{
+		Vector3 origin = gameObject->getTransform()->getWorldPosition();
+		Vector3 unitX(1.0, 0.0, 0.0);
+
+		n = std::min(n, capacity - this->count);
+		for (int k = 0; k < n; k++) {
+			int i = this->count++;
+
+			x[i] = origin.x + Math::randRangeND(-params.startDistanceX, params.startDistanceX);
+			y[i] = origin.y + Math::randRangeND(-params.startDistanceY, params.startDistanceY);
+			z[i] = origin.z + Math::randRangeND(-params.startDistanceZ, params.startDistanceZ);
+
+			Quaternion rotQ(0.0f, params.dirBaseThetaY + Math::randRange(-params.directionVar, params.directionVar), 
+								 params.dirBaseThetaZ + Math::randRange(-params.directionVar, params.directionVar));
+			Vector3 direction = unitX * (Matrix3x3)rotQ;
+			dx[i] = direction.x;
+			dy[i] = direction.y;
+			dz[i] = direction.z;
+
+			speed[i] = Math::randRangeND(params.speedStartMin, params.speedStartMax);
+			age[i] = 0;
+			life[i] = Math::randRange(lifeSpanMin, lifeSpanMax);
+			alpha[i] = params.alpha.getStart();
+		}
+
+		if (count) emitted += n;
+	}
+
+	/*! update
+	  Emits as ParticleEmitter, then moves, fades and retires the live particles
+	  \param dt	elapsed time since last frame
+	  */
+	void ParticleSystem::update(float dt)
+	{
+		Component *self = this;
+		updateAll(&self, 1, dt);
+	}
+
+	void ParticleSystem::updateAll(Component** components, int count, float dt)
+	{
+		JobSystem *jobs = gameObject->getApp()->getJobSystem();
+
+		// spawning uses the shared random number generator, keep it in a fixed order
+		int jobCount = 0;
+		for (int s = 0; s < count; s++) {
+			ParticleSystem *system = (ParticleSystem*)components[s];
+			if (system == NULL) continue;
+			system->ParticleEmitter::update(dt);
+			if (system->getParticleStep(dt) <= 0) {
+				system->rangeCount = 0;				// skipped or suspended by LOD, left as it is
+				continue;
+			}
+			system->splitRanges();
+
+			// bring the terrain's world matrix up to date here, so the jobs only read it
+			if (system->terrain != NULL && system->collisionMode != COLLIDE_NONE)
+				system->terrain->gameObject->getTransform()->getWorldPosition();
+			jobCount += system->rangeCount;
+		}
+
+		// ranges from every system go in one list so small systems share workers too
+		if (jobCount > 0) {
+			ScratchAllocator &scratch = jobs->getScratch(jobs->getCurrentWorker());
+			ParticleSystem **jobSystems = scratch.allocate<ParticleSystem*>(jobCount);
+			Range **jobRanges = scratch.allocate<Range*>(jobCount);
+			int j = 0;
+			for (int s = 0; s < count; s++) {
+				ParticleSystem *system = (ParticleSystem*)components[s];
+				if (system == NULL) continue;
+				for (int r = 0; r < system->rangeCount; r++, j++) {
+					jobSystems[j] = system;
+					jobRanges[j] = &system->ranges[r];
+				}
+			}
+
+			jobs->parallelFor(jobCount, 1, [jobSystems, jobRanges, dt](int begin, int end, int worker) {
+				for (int k = begin; k < end; k++)
+					jobSystems[k]->simulate(*jobRanges[k], jobSystems[k]->getParticleStep(dt));
+			});
+		}
+
+		for (int s = 0; s < count; s++) {
+			ParticleSystem *system = (ParticleSystem*)components[s];
+			if (system == NULL || system->getParticleStep(dt) <= 0) continue;
+			system->removeDead();
+			system->updateBounds();
+		}
+	}
+
+	//! Divides the live particles into jobs of RANGE_SIZE
+	void ParticleSystem::splitRanges()
+	{
+		rangeCount = (count + RANGE_SIZE - 1) / RANGE_SIZE;
+		if ((int)ranges.size() < rangeCount) ranges.resize(rangeCount);
+
+		for (int r = 0; r < rangeCount; r++) {
+			ranges[r].begin = r * RANGE_SIZE;
+			ranges[r].end = std::min(count, (r + 1) * RANGE_SIZE);
+			ranges[r].dead.clear();
+		}
+	}
+
+	/*! Integrates speed, position and alpha for one range of live particles
+	  Only touches the range, so ranges can be simulated in parallel
+	  */
+	void ParticleSystem::simulate(Range &range, float dt)
+	{
+		float acceleration = params.acceleration;
+		float speedMinMax = params.speedMinMax;
+		int i = range.begin;
+		int end = range.end;
+
+#ifdef T3D_SSE
+		// the vector loop handles the common case of a constant speed curve and a straight alpha fade
+		if (params.speed.isConstant() && params.alpha.isLinear()) {
+			float speedScale = params.speed.getStart();
+			float alphaEnd = params.alpha.getEnd();
+			float alphaRange = params.alpha.getStart() - alphaEnd;
+			__m128 vdt = _mm_set1_ps(dt);
+			__m128 vdv = _mm_set1_ps(acceleration * dt);
+			__m128 vlimit = _mm_set1_ps(speedMinMax);
+			__m128 vone = _mm_set1_ps(1.0f);
+			__m128 valphaEnd = _mm_set1_ps(alphaEnd);
+			__m128 valphaRange = _mm_set1_ps(alphaRange);
+			__m128 vspeedScale = _mm_set1_ps(speedScale);
+
+			for (; i + 4 <= end; i += 4) {
+				__m128 a = _mm_add_ps(_mm_loadu_ps(&age[i]), vdt);
+				_mm_storeu_ps(&age[i], a);
+
+				// min speed if decelerating, max speed if accelerating
+				__m128 s = _mm_add_ps(_mm_loadu_ps(&speed[i]), vdv);
+				if (acceleration < 0.0f) s = _mm_max_ps(s, vlimit);
+				else if (acceleration > 0.0f) s = _mm_min_ps(s, vlimit);
+				_mm_storeu_ps(&speed[i], s);
+
+				__m128 step = _mm_mul_ps(_mm_mul_ps(s, vspeedScale), vdt);
+				_mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(_mm_loadu_ps(&dx[i]), step)));
+				_mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(_mm_loadu_ps(&dy[i]), step)));
+				_mm_storeu_ps(&z[i], _mm_add_ps(_mm_loadu_ps(&z[i]), _mm_mul_ps(_mm_loadu_ps(&dz[i]), step)));
+
+				// interpolate alpha from start to end over the lifespan
+				__m128 remaining = _mm_sub_ps(vone, _mm_div_ps(a, _mm_loadu_ps(&life[i])));
+				_mm_storeu_ps(&alpha[i], _mm_add_ps(valphaEnd, _mm_mul_ps(remaining, valphaRange)));
+			}
+		}
+#endif
+
+		for (; i < end; i++) {
+			age[i] += dt;
+
+			float s = speed[i] + acceleration * dt;
+			if ((acceleration < 0.0f && s < speedMinMax) || (acceleration > 0.0f && s > speedMinMax))
+				s = speedMinMax;		// speed limit reached
+			speed[i] = s;
+
+			float t = age[i] / life[i];
+			float step = s * params.speed.evaluate(t) * dt;
+			x[i] += dx[i] * step;
+			y[i] += dy[i] * step;
+			z[i] += dz[i] * step;
+
+			alpha[i] = params.alpha.evaluate(t);
+		}
+
+		if (terrain != NULL && collisionMode != COLLIDE_NONE)
+			collide(range);
+
+		// kills are only recorded here, removeDead applies them once every range is done
+		float minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+		float maxX = -FLT_MAX, maxY = -FLT_MAX, maxZ = -FLT_MAX;
+		for (i = range.begin; i < end; i++) {
+			if (age[i] >= life[i]) {
+				range.dead.push_back(i);
+				continue;
+			}
+			minX = std::min(minX, x[i]); maxX = std::max(maxX, x[i]);
+			minY = std::min(minY, y[i]); maxY = std::max(maxY, y[i]);
+			minZ = std::min(minZ, z[i]); maxZ = std::max(maxZ, z[i]);
+		}
+		range.min[0] = minX; range.min[1] = minY; range.min[2] = minZ;
+		range.max[0] = maxX; range.max[1] = maxY; range.max[2] = maxZ;
+	}
+
+	/*! Finds the particles in a range that are below the terrain and applies the collision mode
+	  The terrain is treated as flat where a particle lands, bounces just send it back up.
+	  */
+	void ParticleSystem::collide(Range &range)
+	{
+		int n = range.end - range.begin;
+		range.ground.resize(n);
+		terrain->getHeights(&x[range.begin], &z[range.begin], &range.ground[0], n);
+
+		for (int k = 0; k < n; k++) {
+			int i = range.begin + k;
+			float ground = range.ground[k];
+			if (y[i] >= ground) continue;
+
+			switch (collisionMode) {
+			case COLLIDE_BOUNCE:
+				y[i] = ground + (ground - y[i]) * restitution;
+				dy[i] = fabs(dy[i]);
+				speed[i] *= restitution;
+				break;
+			case COLLIDE_STICK:
+				// no direction, so acceleration can't move it again
+				y[i] = ground;
+				dx[i] = dy[i] = dz[i] = 0;
+				speed[i] = 0;
+				break;
+			case COLLIDE_DIE:
+				age[i] = life[i];
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	/*! Swaps each expired particle with the last live one
+	  Going from the highest index down, the last particle is always a survivor
+	  */
+	void ParticleSystem::removeDead()
+	{
+		for (int r = rangeCount - 1; r >= 0; r--) {
+			std::vector<int> &dead = ranges[r].dead;
+			for (int d = (int)dead.size() - 1; d >= 0; d--)
+				removeParticle(dead[d]);
+		}
+	}
+
+	void ParticleSystem::removeParticle(int i)
+	{
+		int last = --count;
+		x[i] = x[last]; y[i] = y[last]; z[i] = z[last];
+		dx[i] = dx[last]; dy[i] = dy[last]; dz[i] = dz[last];
+		speed[i] = speed[last];
+		age[i] = age[last];
+		life[i] = life[last];
+		alpha[i] = alpha[last];
+	}
+
+	/*! Fits the drawing object's bounding sphere to the live particles for culling
+	  Combines the survivor bounds found by simulate
+	  */
+	void ParticleSystem::updateBounds()
+	{
+		if (renderObject == NULL) return;
+
+		renderObject->setVisible(count > 0);
+		if (count == 0) return;
+
+		float minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+		float maxX = -FLT_MAX, maxY = -FLT_MAX, maxZ = -FLT_MAX;
+		for (int r = 0; r < rangeCount; r++) {
+			minX = std::min(minX, ranges[r].min[0]); maxX = std::max(maxX, ranges[r].max[0]);
+			minY = std::min(minY, ranges[r].min[1]); maxY = std::max(maxY, ranges[r].max[1]);
+			minZ = std::min(minZ, ranges[r].min[2]); maxZ = std::max(maxZ, ranges[r].max[2]);
+		}
+
+		Vector3 centre((minX + maxX) / 2, (minY + maxY) / 2, (minZ + maxZ) / 2);
+		Vector3 corner(maxX, maxY, maxZ);
+		renderObject->setBoundingSphere(BoundingSphere::create(centre, (corner - centre).length() + params.scale * params.size.getMax()));
+	}
+
+}
@@ -0,0 +1,135 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming
+// =========================================================================================
+//
+// ParticleSystem.h
+//
+// Particle emitter that simulates its particles itself
+// Particles are plain values in structure of arrays form rather than game objects, so a
+// system can run hundreds of thousands of them.  Uses the ParticleEmitter emission curve.
+
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include <vector>
+#include "ParticleEmitter.h"
+#include "DepthSorter.h"
+
+namespace T3D
+{
+	class Material;
+	class Transform;
+	class Terrain;
+
+	//! Particle emitter storing particles in arrays
+	/*! Live particles are packed at the front of each array, dead ones are swapped out.
+	    Positions are in world space and drawn by a game object created in createParticles.
+	  */
+	class ParticleSystem :
+		public ParticleEmitter
+	{
+	public:
+		//! What happens to a particle that reaches the terrain
+		enum CollisionMode {
+			COLLIDE_NONE,
+			COLLIDE_BOUNCE,		//!< reflected upwards, losing speed
+			COLLIDE_STICK,		//!< stops where it lands until it expires
+			COLLIDE_DIE			//!< expires immediately
+		};
+
+		ParticleSystem(float rampUpDuration, float startEmitRate, float runDuration, float emitRate, 
+			float rampDownDuration, float endEmitRate, float emitVariability);
+		virtual ~ParticleSystem();
+
+		/*! Allocates the particles and the game object that draws them
+		  \param n				maximum number of live particles
+		  \param lifeSpanMin	minimum lifespan of particles (seconds)
+		  \param lifeSpanMax	maximum lifespan of particles (seconds)
+		  \param material		material for the particle quads
+		  \param scale			particle quad size
+		  \param parent			parent Transform for the drawing object, should not be transformed (normally the root)
+		  */
+		void createParticles(int n, float lifeSpanMin, float lifeSpanMax, Material *material, float scale, Transform *parent);
+
+		void stop(bool clear);
+		void emit(int n, bool count=false);
+		virtual void update(float dt);
+
+		/*! Updates a batch of systems using the application's job system
+		  Emission runs serially in list order, then every system is split into ranges that are
+		  simulated in parallel.  Each range records its expired particles, which are removed
+		  serially in a fixed order, so results do not depend on the worker count.
+		  */
+		virtual void updateAll(Component** components, int count, float dt);
+
+		// Live particle state for renderers, count entries each
+		int getCount() const { return count; }
+		int getCapacity() const { return capacity; }
+		const float* getX() const { return count ? &x[0] : NULL; }
+		const float* getY() const { return count ? &y[0] : NULL; }
+		const float* getZ() const { return count ? &z[0] : NULL; }
+		const float* getAlpha() const { return count ? &alpha[0] : NULL; }
+		const float* getAge() const { return count ? &age[0] : NULL; }
+		const float* getLife() const { return count ? &life[0] : NULL; }
+		float getScale() const { return params.scale; }
+		Material* getMaterial();
+
+		/*! Orders the live particles for blending, farthest first
+		  Starts from the previous frame's order unless setSortCoherent(false) is called
+		  \return	getCount() particle indices, valid until the particles next change
+		  */
+		const unsigned int* sortBackToFront(const Vector3 &eye, const Vector3 &forward);
+		void setSortCoherent(bool coherent){ sorter.setCoherent(coherent); }
+
+		/*! Collides particles with a terrain each update, heights are looked up a range at a time
+		  \param terrain		the terrain, NULL to turn collisions off
+		  \param mode			what happens to particles that reach it
+		  \param restitution	fraction of speed kept when bouncing
+		  */
+		void setTerrainCollision(Terrain *terrain, CollisionMode mode, float restitution = 0.5f);
+
+	protected:
+		static const int RANGE_SIZE = 4096;		// particles per simulation job, a multiple of 4
+
+		//! Part of the live particles simulated by one job
+		struct Range
+		{
+			int begin, end;
+			std::vector<int> dead;				// expired particles, ascending
+			std::vector<float> ground;			// terrain heights below the range
+			float min[3], max[3];				// bounds of the survivors
+		};
+
+		void splitRanges();
+		void simulate(Range &range, float dt);
+		void collide(Range &range);
+		void removeDead();
+		void removeParticle(int i);
+		void updateBounds();
+
+		int count;						// live particles
+		int capacity;					// array size
+		GameObject *renderObject;		// draws the particles
+		DepthSorter sorter;
+		std::vector<Range> ranges;		// this update's jobs
+		int rangeCount;
+
+		Terrain *terrain;				// collided with unless NULL
+		CollisionMode collisionMode;
+		float restitution;
+
+		// per particle state
+		std::vector<float> x, y, z;		// world position
+		std::vector<float> dx, dy, dz;	// direction of motion (unit vector)
+		std::vector<float> speed;
+		std::vector<float> age;			// seconds since emitted
+		std::vector<float> life;		// lifespan
+		std::vector<float> alpha;
+
+		// lifespan range, the other settings are in params
+		float lifeSpanMin, lifeSpanMax;
+	};
+
+}
+
+#endif //PARTICLESYSTEM_H
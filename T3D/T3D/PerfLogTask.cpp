@@ -12,7 +12,7 @@
 #include <fstream>
 #include <iomanip>
 #include "perflogtask.h"
-#include "GLRenderer.h"
+#include "Renderer.h"
 
 namespace T3D{
 
@@ -45,6 +45,9 @@ namespace T3D{
 
 		sampleCount = 0;
 		frameRateTotal = 0;
+
+		stateCallsTotal = 0;
+		stateCallsSkippedTotal = 0;
 	}
 
 	void PerfLogTask::log(){		
@@ -56,6 +59,8 @@ namespace T3D{
 		logfile << "elapsed time: " << elapsedTime << "\n";
 		logfile.precision(1);
 		logfile << "frame rate (min/avg/max): " << minFrameRate << " / " << frameCount/elapsedTime << " / " << maxFrameRate << "\n";
+		if (frameCount > 0)
+			logfile << "state calls per frame (made/skipped): " << stateCallsTotal/frameCount << " / " << stateCallsSkippedTotal/frameCount << "\n";
 		logfile.close();
 	}
 
@@ -83,6 +88,10 @@ namespace T3D{
 		sampleFrames++;
 		sampleElapsed += dt;
 
+		Renderer *renderer = app->getRenderer();
+		stateCallsTotal += renderer->state_calls_last_frame;
+		stateCallsSkippedTotal += renderer->state_calls_skipped_last_frame;
+
 		if (sampleElapsed > PERF_SAMPLING_PERIOD)			// update every quarter second
 		{
 			double currentFrameRate = sampleFrames/sampleElapsed;
@@ -90,7 +99,7 @@ namespace T3D{
 
 			
 			unsigned int polygons_in_scene = count_polys(app->getRoot());
-			unsigned int polys_recently_rendered = ((GLRenderer*)app->getRenderer())->polys_last_frame;
+			unsigned int polys_recently_rendered = app->getRenderer()->polys_last_frame;
 		
 			if (elapsedTime > 3 * PERF_SAMPLING_PERIOD)		// allow some settling time
 			{
@@ -119,6 +128,7 @@ namespace T3D{
 				//	ss << ", frame rate: min=" << minFrameRate << ", avg=" << averageFrameRate << ", max=" << maxFrameRate << ", cur=" << currentFrameRate << " (avg=" << avgFrameRate << ")";
 					ss << ", frame rate: " << "cur= " << currentFrameRate << ", avg = " << avgFrameRate;
 					ss << ", polys: scene=" << polygons_in_scene << ", frame=" << polys_recently_rendered;
+					ss << ", state calls: made=" << renderer->state_calls_last_frame << ", skipped=" << renderer->state_calls_skipped_last_frame;
 
 					int w = 1024;		// texture width, should be large enough for most diagnostics
 					int h = 32;			// should be enough for single line (text wrap is not supported)
@@ -45,6 +45,10 @@ namespace T3D{
 		long int sampleCount;
 		float frameRateTotal;
 
+		// GL state calls made and skipped as redundant by the renderer
+		double stateCallsTotal;
+		double stateCallsSkippedTotal;
+
 		bool diagDisplay;		// text overlay display flag
 		Texture *diagOverlay;	// last overlay texture generated
 
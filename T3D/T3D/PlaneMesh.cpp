@@ -51,6 +51,7 @@ namespace T3D{
 		vertices[(i*(density+1)+j)*3] = x;
 		vertices[(i*(density+1)+j)*3+1] = y;
 		vertices[(i*(density+1)+j)*3+2] = z;
+		version++;
 	}
 
 	Vector3 PlaneMesh::getVertex(int i, int j){
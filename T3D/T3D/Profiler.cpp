@@ -0,0 +1,62 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// profiler.cpp
+//
+// Simple static class to accumulate time spent in each phase of a frame
+// Disabled by default, in which case begin/end cost a single test.
+
+#include "Profiler.h"
+#include "Clock.h"
+
+namespace T3D
+{
+	bool Profiler::enabled = false;
+	long long Profiler::started[PHASE_COUNT];
+	long long Profiler::total[PHASE_COUNT];
+	int Profiler::calls[PHASE_COUNT];
+
+	void Profiler::begin(Phase p)
+	{
+		if (enabled)
+			started[p] = Clock::microseconds();
+	}
+
+	void Profiler::end(Phase p)
+	{
+		if (enabled)
+		{
+			total[p] += Clock::microseconds() - started[p];
+			calls[p]++;
+		}
+	}
+
+	void Profiler::reset()
+	{
+		for (int i = 0; i < PHASE_COUNT; i++)
+		{
+			started[i] = 0;
+			total[i] = 0;
+			calls[i] = 0;
+		}
+	}
+
+	double Profiler::getSeconds(Phase p)
+	{
+		return total[p] / 1000000.0;
+	}
+
+	int Profiler::getCalls(Phase p)
+	{
+		return calls[p];
+	}
+
+	const char* Profiler::getName(Phase p)
+	{
+		static const char* names[PHASE_COUNT] = {
+			"tasks", "components", "world_matrices", "culling", "queue_build", "draw"
+		};
+		return names[p];
+	}
+}
@@ -0,0 +1,60 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// profiler.h
+//
+// Simple static class to accumulate time spent in each phase of a frame
+// Disabled by default, in which case begin/end cost a single test.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+namespace T3D
+{
+	class Profiler
+	{
+	public:
+		enum Phase {
+			TASKS,				// T3DApplication::updateTasks
+			COMPONENTS,			// T3DApplication::updateComponents
+			WORLD_MATRICES,		// T3DApplication::updateWorldMatrices, a no-op without a flat hierarchy
+			CULLING,			// Renderer::buildRenderQueue
+			QUEUE_BUILD,		// ordering the culled objects for drawing
+			DRAW,				// material loads and draw calls
+			PHASE_COUNT
+		};
+
+		static void enable(bool e){ enabled = e; }
+		static bool isEnabled(){ return enabled; }
+
+		static void begin(Phase p);
+		static void end(Phase p);
+
+		//! Clears all accumulated times and counts
+		static void reset();
+
+		static double getSeconds(Phase p);		// total time spent in phase since reset
+		static int getCalls(Phase p);			// number of begin/end pairs since reset
+		static const char* getName(Phase p);
+
+		//! Times the enclosing block
+		class Scope
+		{
+		public:
+			Scope(Phase p) : phase(p) { begin(phase); }
+			~Scope(){ end(phase); }
+		private:
+			Phase phase;
+		};
+
+	private:
+		static bool enabled;
+		static long long started[PHASE_COUNT];
+		static long long total[PHASE_COUNT];
+		static int calls[PHASE_COUNT];
+	};
+}
+
+#endif
+
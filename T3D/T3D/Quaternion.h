@@ -102,14 +102,15 @@ namespace T3D {
 		  */
 		Quaternion(const Matrix3x3 &m)
 		{	
+			// clamped at zero - rounding can push these a fraction below for 180 degree turns
 			float t = m[0][0]+m[1][1]+m[2][2];
-			float r = sqrt(1+t);
+			float r = sqrt(std::max(0.0f,1+t));
 			s = 0.5f*r;
-			v.x = 0.5f*sqrt(1+m[0][0]-m[1][1]-m[2][2]); 
+			v.x = 0.5f*sqrt(std::max(0.0f,1+m[0][0]-m[1][1]-m[2][2])); 
 			if ((v.x>0 && m[2][1]-m[1][2]<0) || (v.x<0 && m[2][1]-m[1][2]>0)) v.x = -v.x;
-			v.y = 0.5f*sqrt(1-m[0][0]+m[1][1]-m[2][2]); 
+			v.y = 0.5f*sqrt(std::max(0.0f,1-m[0][0]+m[1][1]-m[2][2])); 
 			if ((v.y>0 && m[0][2]-m[2][0]<0) || (v.y<0 && m[0][2]-m[2][0]>0)) v.y = -v.y;
-			v.z = 0.5f*sqrt(1-m[0][0]-m[1][1]+m[2][2]); 
+			v.z = 0.5f*sqrt(std::max(0.0f,1-m[0][0]-m[1][1]+m[2][2])); 
 			if ((v.z>0 && m[1][0]-m[0][1]<0) || (v.z<0 && m[1][0]-m[0][1]>0)) v.z = -v.z;
 		} 
 		
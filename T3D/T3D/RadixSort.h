@@ -0,0 +1,79 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// radixsort.h
+//
+// LSD radix sort on unsigned integer keys, all implementation is in the header
+// Items are any type with an unsigned member called key (uint64_t or uint32_t).  Sorting is stable
+// and passes over digits that are the same in every key are skipped, so keys only using a few
+// bits are cheap.
+
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace T3D
+{
+	//! Maps a float to a key whose unsigned order matches the float order, negatives included
+	inline uint32_t floatSortKey(float f)
+	{
+		uint32_t bits;
+		memcpy(&bits, &f, sizeof(bits));
+		return (bits & 0x80000000) ? ~bits : bits | 0x80000000;
+	}
+
+	/*! Sorts items by ascending key
+	  \param items		The items to sort, sorted on return
+	  \param buffer		Scratch space, resized as needed.  Keep it between calls to avoid reallocating
+	  */
+	template <class T>
+	void radixSort(std::vector<T> &items, std::vector<T> &buffer)
+	{
+		const int digits = sizeof(items[0].key);
+		size_t count = items.size();
+		if (count < 2) return;
+		buffer.resize(count);
+
+		// histograms for all the byte digits in one pass
+		size_t histogram[digits][256] = {};
+		for (size_t i = 0; i < count; i++) {
+			uint64_t key = items[i].key;
+			for (int d = 0; d < digits; d++)
+				histogram[d][(key >> (d * 8)) & 0xff]++;
+		}
+
+		T *src = &items[0];
+		T *dst = &buffer[0];
+		for (int d = 0; d < digits; d++) {
+			size_t *h = histogram[d];
+
+			// every key has the same digit, order wouldn't change
+			if (h[(src[0].key >> (d * 8)) & 0xff] == count)
+				continue;
+
+			size_t offset = 0;
+			for (int b = 0; b < 256; b++) {
+				size_t n = h[b];
+				h[b] = offset;
+				offset += n;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				dst[h[(src[i].key >> (d * 8)) & 0xff]++] = src[i];
+
+			T *t = src; src = dst; dst = t;
+		}
+
+		// odd number of passes leaves the result in the buffer
+		if (src != &items[0])
+			items.swap(buffer);
+	}
+}
+
+#endif
+
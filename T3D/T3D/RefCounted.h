@@ -0,0 +1,37 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// refcounted.h
+//
+// Base for resources shared by several owners, such as meshes
+// A new object has no references.  Each owner calls addRef when it starts using the object and
+// release when it is done, and the object deletes itself when the last reference is released.
+// Counts are not atomic, so references are taken and released on the main thread.
+
+#ifndef REFCOUNTED_H
+#define REFCOUNTED_H
+
+namespace T3D
+{
+	class RefCounted
+	{
+	public:
+		RefCounted(void) : refCount(0) {}
+		virtual ~RefCounted(void) {}
+
+		void addRef(){ refCount++; }
+		void release(){ if (--refCount <= 0) delete this; }
+		int getRefCount() const{ return refCount; }
+
+	protected:
+		// a copy is a new object, nobody holds a reference to it yet
+		RefCounted(const RefCounted &r) : refCount(0) {}
+		RefCounted& operator=(const RefCounted &r){ return *this; }
+
+	private:
+		int refCount;
+	};
+}
+
+#endif
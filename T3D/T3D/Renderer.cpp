@@ -9,11 +9,16 @@
 // Abstract base class for all rendering operations
 // Recursively draws all objects in scene graph
 
+#include <string.h>
+
 #include "Renderer.h"
 #include "GameObject.h"
 #include "Transform.h"
 #include "Camera.h"
 #include "Cube.h"
+#include "Profiler.h"
+#include "RadixSort.h"
+#include "ParticleSystem.h"
 
 namespace T3D
 {
@@ -40,6 +45,13 @@ namespace T3D
 		showPoints = false;
 		showGrid = false;
 		showAxes = false;
+
+		polys_last_frame = 0;
+		draws_last_frame = 0;
+		material_switches_last_frame = 0;
+		instanced_draws_last_frame = 0;
+		state_calls_last_frame = 0;
+		state_calls_skipped_last_frame = 0;
 	}
 
 	/*! Destructor
@@ -71,93 +83,162 @@ namespace T3D
 	  */
 	Material* Renderer::createMaterial(int priority){
 		Material* m = new Material();
-		materials[priority].push_back(m);
+		m->setPriority(priority);
+		materials.push_back(m);
 		return m;
 	}
 
-	struct GameObjectCameraDistanceCompare
-	{
-		bool operator()(const GameObject *t1, const GameObject *t2) const {
-			return t1->getDistanceToCamera() < t2->getDistanceToCamera();
+	/*! Render list sort key, most significant bits first
+	    priority (4) | sorted draw (1) | shader (5) | texture (8) | material (14) | mesh (12) | depth, near first (20)
+	  or for materials with sorted draw
+	    priority (4) | sorted draw (1) | depth, far first (24) | material (16) | mesh (12) | unused (7)
+	  IDs are truncated to fit, a collision only costs an extra material switch or a shorter instance run.
+	  */
+	static const int KEY_PRIORITY_SHIFT = 60;
+	static const int KEY_SORTED_SHIFT = 59;
+	static const int KEY_SHADER_SHIFT = 54;
+	static const int KEY_TEXTURE_SHIFT = 46;
+	static const int KEY_MATERIAL_SHIFT = 32;
+	static const int KEY_MESH_SHIFT = 20;
+	static const int KEY_SORTED_DEPTH_SHIFT = 35;
+	static const int KEY_SORTED_MATERIAL_SHIFT = 19;
+	static const int KEY_SORTED_MESH_SHIFT = 7;
+	static const uint32_t KEY_DEPTH_MAX = 0xffffff;
+
+	// Top 24 bits of a non-negative float, which order the same way as the float
+	static uint32_t quantiseDepth(float distance){
+		uint32_t bits;
+		memcpy(&bits, &distance, sizeof(bits));
+		return bits >> 7;
+	}
+
+	/*! Adds an object to the render list if it is visible and has a material that is drawn
+	  \param object		The object to add
+	  */
+	void Renderer::queueObject(GameObject *object){
+		Material *m = object->getMaterial();
+		if (m == NULL || m->getPriority() < 0 || !object->isVisible()) return;
+
+		// Note using squared distance as we only care about relative distance
+		float distance = cameraPosition.squaredDistance(object->getTransform()->getWorldPosition());
+		object->setDistanceToCamera(distance);
+		uint32_t depth = quantiseDepth(distance);
+
+		Mesh *mesh = object->getMesh();
+		uint64_t meshID = mesh ? mesh->getID() & 0xfff : 0;
+
+		uint64_t key = (uint64_t)m->getPriority() << KEY_PRIORITY_SHIFT;
+		if (!m->getSortedDraw()) {
+			Shader *shader = m->getShader();
+			uint64_t shaderID = shader ? shader->getID() : 0;
+			uint64_t textureID = m->isTextured() ? m->getTexID() : 0;
+			key |= (shaderID & 0x1f) << KEY_SHADER_SHIFT;
+			key |= (textureID & 0xff) << KEY_TEXTURE_SHIFT;
+			key |= (uint64_t)(m->getID() & 0x3fff) << KEY_MATERIAL_SHIFT;
+			key |= meshID << KEY_MESH_SHIFT;
+			key |= depth >> 4;
+		}
+		else {
+			key |= (uint64_t)1 << KEY_SORTED_SHIFT;
+			key |= (uint64_t)(KEY_DEPTH_MAX - depth) << KEY_SORTED_DEPTH_SHIFT;
+			key |= (uint64_t)(m->getID() & 0xffff) << KEY_SORTED_MATERIAL_SHIFT;
+			key |= meshID << KEY_SORTED_MESH_SHIFT;
 		}
-	};
+
+		RenderItem item = { key, object };
+		renderList.push_back(item);
+	}
 
 	/*! Renders the scenegraph
 	  This method is responsible for sorting by material and rendering game objects in material priority order
+	  The work is done in three passes (culling, queue build and draw) so that each can be profiled
 	  \param root	The root of the scenegraph to be rendered
 	  */
 	void Renderer::render(Transform *root){
 
-		if (camera == NULL) return;
+		polys_last_frame = 0;
+		draws_last_frame = 0;
+		material_switches_last_frame = 0;
+		instanced_draws_last_frame = 0;
+		state_calls_last_frame = 0;
+		state_calls_skipped_last_frame = 0;
 
-		Vector3 cameraPos;
-		float distance;
-		GameObject *object;
+		if (camera == NULL) return;
 
 		// Single common camera for all rendering
-		cameraPos = camera->gameObject->getTransform()->getWorldPosition();
+		Profiler::begin(Profiler::CULLING);
+		cameraPosition = camera->gameObject->getTransform()->getWorldPosition();
 		camera->calculateWorldSpaceFrustum();
 
+		renderList.clear();
 		buildRenderQueue(root);
+		Profiler::end(Profiler::CULLING);
 
-		for (int i=0; i<PRIORITY_LEVELS; i++) {
-
-			// temp list of objects requiring sorted draw order (if any)
-			std::priority_queue<GameObject*, std::vector<GameObject*>, GameObjectCameraDistanceCompare> sorted;
-
-			for (auto mit : materials[i]) {
-			//for (mit = materials[i].begin(); mit!=materials[i].end(); mit++){
-				
-				std::queue<GameObject*> &q = mit->getQueue();	// objects to be drawn
-
-				if (!mit->getSortedDraw()) {
-					// objects for normal unsorted materials are drawn immediately
-					loadMaterial(mit);
-					while (!q.empty()) {
-						object = q.front();
-						if (object->isVisible()) {
-							draw(object);
-						}
-						q.pop();
-					}
-					unloadMaterial(mit);
-				}
-				else {
-					// objects to be sorted and drawn later
-					while (!q.empty()) {
-						object = q.front();
-						if (object->isVisible()) {
-							// Note using squared distance as we only care about relative distance
-							distance = cameraPos.squaredDistance(object->getTransform()->getWorldPosition());
-							object->setDistanceToCamera(distance);
-							sorted.push(object);
-						}
-						q.pop();
-					}
-				}
+		// Order by priority, then by state (opaque) or distance (sorted draw)
+		Profiler::begin(Profiler::QUEUE_BUILD);
+		radixSort(renderList, sortBuffer);
+		Profiler::end(Profiler::QUEUE_BUILD);
+
+		// Draw, only loading a material when it changes and passing runs of objects
+		// that share a mesh to drawInstances
+		Profiler::begin(Profiler::DRAW);
+		Material *loaded = NULL;			// current loaded material
+		unsigned int i = 0;
+		while (i < renderList.size()) {
+			GameObject *object = renderList[i].object;
+			if (loaded != object->getMaterial()) {
+				unloadMaterial(loaded);
+				loaded = object->getMaterial();
+				loadMaterial(loaded);
+				material_switches_last_frame++;
 			}
 
-			// Draw sorted objects (if any)
-			Material *loaded = NULL;			// current loaded material
-			while (!sorted.empty()) {
-				object = sorted.top();
-				if (loaded != object->getMaterial()) {
-					// only load material if changed
-					loaded = object->getMaterial();
-					loadMaterial(loaded);
-				}
+			unsigned int end = i + 1;
+			Mesh *mesh = object->getMesh();
+			if (mesh != NULL) {
+				while (end < renderList.size() && renderList[end].object->getMesh() == mesh
+					&& renderList[end].object->getMaterial() == loaded)
+					end++;
+			}
+
+			if (end - i > 1) {
+				instanceList.clear();
+				for (unsigned int j = i; j < end; j++)
+					instanceList.push_back(renderList[j].object);
+				drawInstances(&instanceList[0], end - i);
+				instanced_draws_last_frame++;
+			}
+			else if (object->getParticleSystem() != NULL) {
+				drawParticles(object->getParticleSystem());
+			}
+			else {
 				draw(object);
-				sorted.pop();
 			}
+			draws_last_frame += end - i;
+			i = end;
 		}
+		unloadMaterial(loaded);
+		Profiler::end(Profiler::DRAW);
+	}
+
+	/*! Draws objects sharing a mesh and material one at a time
+	  \param objects	The objects to draw
+	  \param count		Number of objects
+	  */
+	void Renderer::drawInstances(GameObject **objects, int count){
+		for (int i = 0; i < count; i++)
+			draw(objects[i]);
+	}
+
+	void Renderer::drawParticles(ParticleSystem *particles){
+		polys_last_frame += particles->getCount();
 	}
 
 	//add each gameobject in depth first order
-	static void buildRenderQueueDontCull(Transform* root) {
+	void Renderer::buildRenderQueueDontCull(Transform* root) {
 		GameObject* obj = root->gameObject;
 		if (obj) {
-			Material* m = obj->getMaterial();
-			if (m) m->addToQueue(obj);
+			queueObject(obj);
 		}
 
 		for (auto child : root->children)
@@ -167,9 +248,9 @@ namespace T3D
 
 	}
 
-	/*! Sorts game objects by material
-	  This method traverses the scenegraph and adds game objects their respective material's render queues
-	  \param root	The root of the scenegraph to be sorted
+	/*! Culls the scenegraph against the camera
+	  This method traverses the scenegraph and adds visible game objects to the render list
+	  \param root	The root of the scenegraph to be culled
 	  */
 	void Renderer::buildRenderQueue(Transform *root){
 			BoundingSphere rootBoundingSphere = root->getWorldMatrix() * root->getBoundingSphere();
@@ -189,8 +270,7 @@ namespace T3D
 					GameObject* obj = root->gameObject;
 					if (obj) {
 						//if (camera->contains(obj->getBoundingSphere()) != Camera::None) {
-							Material* m = obj->getMaterial();
-							if (m) m->addToQueue(obj);
+							queueObject(obj);
 						//}
 					}
 
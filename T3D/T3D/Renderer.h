@@ -16,11 +16,13 @@
 #include "Light.h"
 #include "Mesh.h"
 #include "Texture.h"
+#include <stdint.h>
 
 
 namespace T3D
 {
 	class Camera;
+	class ParticleSystem;
 
 	//! Generic class for renderers
 	/*! The render is responsible for managing materials and drawing meshes
@@ -46,6 +48,16 @@ namespace T3D
 		
 		virtual void draw(GameObject *object) = 0;
 
+		/*! Draws objects sharing a mesh and material, the material is already loaded
+		  The default just draws each in turn, renderers that can instance override it
+		  */
+		virtual void drawInstances(GameObject **objects, int count);
+
+		/*! Draws the live particles of a system as camera facing quads, the material is already loaded
+		  The default only counts the quads
+		  */
+		virtual void drawParticles(ParticleSystem *particles);
+
 		virtual void loadTexture(Texture *tex, bool repeat = false) = 0;	// load Texture into GL
 		virtual void reloadTexture(Texture *tex) = 0;						// reload previously loaded Texture (refresh)
 		virtual void unloadTexture(Texture *tex) = 0;						// unload Texture from GL
@@ -69,6 +81,8 @@ namespace T3D
 
 		enum CullNeeded { Cull, NoCull };
 		virtual void buildRenderQueue(Transform *root);
+		void buildRenderQueueDontCull(Transform *root);
+		void queueObject(GameObject *object);
 
 		virtual void loadMaterial(Material *mat) = 0;
 		virtual void unloadMaterial(Material *mat) = 0;
@@ -90,8 +104,26 @@ namespace T3D
 
 		bool showWireframe, showPoints, showGrid, showAxes;
 
+		// Statistics for the last call to render (reset at the start of each render)
+		unsigned int polys_last_frame;				// polygons sent to drawMesh or drawParticles
+		unsigned int draws_last_frame;				// calls to draw
+		unsigned int material_switches_last_frame;	// calls to loadMaterial
+		unsigned int instanced_draws_last_frame;		// calls to drawInstances (each counts count draws)
+		unsigned int state_calls_last_frame;			// GL state calls made while drawing (GLRenderer)
+		unsigned int state_calls_skipped_last_frame;	// redundant GL state calls skipped (GLRenderer)
+
 	private:
-		std::vector<Material*> materials[PRIORITY_LEVELS];
+		struct RenderItem
+		{
+			uint64_t key;				// see queueObject for the layout
+			GameObject *object;
+		};
+
+		std::vector<Material*> materials;
+		std::vector<RenderItem> renderList;		// culled objects, in draw order once sorted
+		std::vector<RenderItem> sortBuffer;		// radix sort scratch, kept to avoid reallocating
+		Vector3 cameraPosition;					// for the frame being rendered
+		std::vector<GameObject*> instanceList;	// run of objects passed to drawInstances
 	};
 }
 
@@ -26,6 +26,7 @@ namespace T3D
 		~RotateBehaviour(void);
 		
 		virtual void update(float dt);
+		virtual UpdateAccess getUpdateAccess() const { return ACCESS_OWN_TRANSFORM; }
 	protected:
 		Vector3 rotation;
 	};
@@ -14,8 +14,12 @@
 
 namespace T3D{
 
+	unsigned int Shader::nextID = 1;
+
 	Shader::Shader(std::string vertFilename, std::string fragFilename)
 	{
+		shaderID = nextID++;
+
 		//std::cout << "Loading shader source...\n";
 		std::ifstream vertfile(vertFilename);
 		std::ifstream fragfile(fragFilename);
@@ -24,8 +24,14 @@ namespace T3D{
 		virtual void bindShader() = 0;
 		virtual void unbindShader() = 0;
 
+		unsigned int getID(){ return shaderID; }		// unique, used to group objects by shader when drawing
+
 	protected:
 		std::string vertSource, fragSource;
+
+	private:
+		unsigned int shaderID;
+		static unsigned int nextID;
 	};
 
 }
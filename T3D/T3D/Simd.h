@@ -0,0 +1,25 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// simd.h
+//
+// Works out which SIMD instruction sets the engine can use on the target being compiled for
+// T3D_SSE is defined with the SSE intrinsics included, T3D_SSE2 also with SSE2.  Code using
+// them keeps a scalar path for targets that define neither.
+
+#ifndef SIMD_H
+#define SIMD_H
+
+// both are part of every x64 target, and VS2013 builds Win32 with /arch:SSE2 by default
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define T3D_SSE
+#include <xmmintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define T3D_SSE2
+#include <emmintrin.h>
+#endif
+
+#endif
@@ -11,10 +11,13 @@
 
 #include <stdlib.h>     /* srand, rand */
 #include <time.h>       /* time */
+#include <math.h>
+#include <algorithm>
 
 #include "T3DApplication.h"
 #include "Input.h"
 #include "Task.h"
+#include "Profiler.h"
 
 namespace T3D 
 {
@@ -25,6 +28,18 @@ namespace T3D
 		srand((unsigned int)time(NULL));
 
 		root = NULL;
+		hierarchy = NULL;
+		jobSystem = new JobSystem(1);
+		components = new ComponentManager(this);
+		meshCache = new MeshCache();
+
+		dt = 0;
+		fixedTimestep = false;
+		fixedStep = 1.0f/60.0f;
+		maxCatchUpSteps = 5;
+		interpolate = false;
+		accumulator = 0;
+		interpolationAlpha = 1.0f;
 		Input::init();
 		soundManager = new SoundManager();
 	}
@@ -32,6 +47,15 @@ namespace T3D
 
 	T3DApplication::~T3DApplication(void)
 	{
+		delete hierarchy;
+		hierarchy = NULL;
+		delete components;
+		components = NULL;
+		delete jobSystem;
+		jobSystem = NULL;
+		delete meshCache;				// objects still using a cached mesh keep it alive
+		meshCache = NULL;
+
 		list<Task*>::iterator it;
 
 		for ( it=tasks.begin() ; it != tasks.end(); it++ )
@@ -67,16 +91,124 @@ namespace T3D
 		return it != tasks.end();
 	}
 
-	void T3DApplication::updateComponents(Transform *t){
-		if (t->gameObject!=NULL)
+	void T3DApplication::updateComponents(){
+		components->update(dt);
+	}
+
+	void T3DApplication::setFlatHierarchy(bool enable){
+		if (enable && hierarchy == NULL)
+		{
+			hierarchy = new TransformHierarchy(root);
+		}
+		else if (!enable && hierarchy != NULL)
+		{
+			delete hierarchy;
+			hierarchy = NULL;
+		}
+	}
+
+	// Replaces the pool, must not be called while jobs are running
+	void T3DApplication::setWorkerCount(int workers){
+		if (workers != jobSystem->getWorkerCount())
 		{
-			t->gameObject->update(dt);
+			delete jobSystem;
+			jobSystem = new JobSystem(workers);
 		}
+	}
+
+	// Without a flattened hierarchy world matrices are left to be computed lazily on demand
+	void T3DApplication::updateWorldMatrices(){
+		if (hierarchy != NULL)
+		{
+			hierarchy->update();
+		}
+	}
 
-		for(unsigned int i = 0; i < t->children.size(); ++i)
+	// Unlike updateWorldMatrices this always leaves every world matrix current,
+	// walking the tree when there is no flattened hierarchy
+	void T3DApplication::refreshWorldMatrices(){
+		if (hierarchy != NULL)
 		{
-			updateComponents(t->children[i]);
+			hierarchy->update();
 		}
+		else if (root != NULL)
+		{
+			root->refreshWorldMatrices();
+		}
+	}
+
+	void T3DApplication::setFixedTimestep(float step, int maxSteps, bool interpolate){
+		fixedTimestep = true;
+		fixedStep = step;
+		maxCatchUpSteps = maxSteps;
+		this->interpolate = interpolate;
+		accumulator = 0;
+	}
+
+	void T3DApplication::setVariableTimestep(){
+		fixedTimestep = false;
+		interpolationAlpha = 1.0f;
+	}
+
+	void T3DApplication::advance(double frameTime){
+		if (!fixedTimestep)
+		{
+			dt = (float)frameTime;
+			Profiler::begin(Profiler::TASKS);
+			updateTasks();
+			Profiler::end(Profiler::TASKS);
+			Profiler::begin(Profiler::COMPONENTS);
+			updateComponents();
+			Profiler::end(Profiler::COMPONENTS);
+			Profiler::begin(Profiler::WORLD_MATRICES);
+			updateWorldMatrices();
+			Profiler::end(Profiler::WORLD_MATRICES);
+			return;
+		}
+
+		// tasks (timers, diagnostics) follow the real frame rate
+		dt = (float)frameTime;
+		Profiler::begin(Profiler::TASKS);
+		updateTasks();
+		Profiler::end(Profiler::TASKS);
+
+		accumulator += frameTime;
+		int steps = std::min((int)(accumulator / fixedStep), maxCatchUpSteps);
+
+		for (int i = 0; i < steps; ++i)
+		{
+			// only the state before the final step is needed to interpolate
+			if (interpolate && i == steps - 1)
+				interpolator.capture(root);
+
+			dt = fixedStep;
+			Profiler::begin(Profiler::COMPONENTS);
+			updateComponents();
+			Profiler::end(Profiler::COMPONENTS);
+			accumulator -= fixedStep;
+		}
+
+		// fell too far behind, drop the backlog rather than trying to catch up
+		if (accumulator >= fixedStep)
+			accumulator = fmod(accumulator, (double)fixedStep);
+
+		Profiler::begin(Profiler::WORLD_MATRICES);
+		updateWorldMatrices();
+		Profiler::end(Profiler::WORLD_MATRICES);
+		interpolationAlpha = (float)(accumulator / fixedStep);
+	}
+
+	void T3DApplication::renderFrame(){
+		bool blend = fixedTimestep && interpolate;
+		if (blend)
+			interpolator.apply(interpolationAlpha);
+
+		renderer->prerender();
+		renderer->render(root);
+		renderer->postrender();
+
+		if (blend)
+			interpolator.restore();
 	}
 
 	void T3DApplication::updateTasks(){
@@ -18,6 +18,11 @@
 #include "Font.h"
 #include <list>
 #include "SoundManager.h"
+#include "JobSystem.h"
+#include "ComponentManager.h"
+#include "Clock.h"
+#include "TransformInterpolator.h"
+#include "MeshCache.h"
 
 using namespace std;
 
@@ -35,12 +40,45 @@ namespace T3D
 		virtual int run() = 0;
 		virtual void quit() = 0;
 		virtual void updateTasks();
-		virtual void updateComponents(Transform *t);
+		virtual void updateComponents();
+		virtual void updateWorldMatrices();
+		void refreshWorldMatrices();
+
+		/*! Advances the simulation by one rendered frame
+		  Tasks always see the real frame time.  Components see it too in variable timestep mode,
+		  otherwise they are stepped at the fixed rate as many times as the accumulated time allows.
+		  \param frameTime		seconds since the previous frame
+		  */
+		virtual void advance(double frameTime);
+
+		//! Draws the scene, interpolated between fixed steps when enabled
+		virtual void renderFrame();
+
+		/*! Switches to fixed timestep simulation
+		  \param step				simulation step in seconds
+		  \param maxSteps			most steps run in one frame, time beyond this is dropped
+		  \param interpolate		blend transforms between the last two steps when rendering
+		  */
+		void setFixedTimestep(float step, int maxSteps = 5, bool interpolate = true);
+		void setVariableTimestep();
+		bool isFixedTimestep(){ return fixedTimestep; }
 		virtual font *getFont(const char *filename, int pointSize) { return NULL; }
 
 		Transform* getRoot(){return root;};
 		Renderer* getRenderer(){return renderer;};
 
+		// Optional flattened storage for the scene graph matrices (off by default)
+		void setFlatHierarchy(bool enable);
+		TransformHierarchy* getHierarchy(){return hierarchy;};
+
+		// Thread pool shared by engine subsystems, one worker (the main thread) by default
+		JobSystem* getJobSystem(){return jobSystem;};
+		ComponentManager* getComponentManager(){return components;};
+
+		// Shared meshes, use instead of new Sphere etc. when many objects look the same
+		MeshCache* getMeshCache(){return meshCache;};
+		void setWorkerCount(int workers);
+
 		void addTask(Task *t);
 		void removeTask(Task *t);
 		Task *findTask(const char *name);
@@ -52,7 +90,20 @@ namespace T3D
 		bool running;
 		Transform *root;
 		Renderer *renderer;
-		float lastFrame, dt;
+		TransformHierarchy *hierarchy;
+		JobSystem *jobSystem;
+		ComponentManager *components;
+		MeshCache *meshCache;
+		Clock clock;					// frame timer
+		float dt;						// time step being simulated
+
+		bool fixedTimestep;
+		float fixedStep;
+		int maxCatchUpSteps;
+		bool interpolate;
+		double accumulator;				// simulation time owed
+		float interpolationAlpha;		// fraction of a step between the last simulated state and now
+		TransformInterpolator interpolator;
 
 	private:
 		list<Task*> tasks;
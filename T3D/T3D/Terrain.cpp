@@ -15,6 +15,7 @@
 #include "Math.h"
 #include "GameObject.h"
 #include "Transform.h"
+#include "Simd.h"
 
 namespace T3D{
 
@@ -25,6 +26,9 @@ namespace T3D{
 
 	Terrain::Terrain()
 	{
+		size = 0;
+		gridSize = 1;
+		density = 0;
 	}
 
 	///-------------------------------------------------------------------------------------------------
@@ -46,28 +50,126 @@ namespace T3D{
 	/// @return	The interpolated height.
 
 	float Terrain::getHeight(Vector3 pos){
-		Vector3 terrainPos = gameObject->getTransform()->getWorldPosition();
-		Vector3 relativePos = pos-terrainPos;
-		float xPos = Math::clamp((relativePos.x+size/2.0f) / gridSize, 0, size/gridSize);
-		float yPos = Math::clamp((relativePos.z+size/2.0f) / gridSize, 0, size/gridSize);
-
-		int xlow = int(floor(xPos));
-		int ylow = int(floor(yPos));
-		int xhigh = int(ceil(xPos));
-		int yhigh = int(ceil(yPos));
+		float height;
+		getHeights(&pos.x, &pos.z, &height, 1);
+		return height;
+	}
 
-		PlaneMesh *mesh = (PlaneMesh*)gameObject->getMesh();
-		Vector3 xlyl = mesh->getVertex(xlow,ylow);
-		Vector3 xlyh = mesh->getVertex(xlow,yhigh);
-		Vector3 xhyl = mesh->getVertex(xhigh,ylow);
-		Vector3 xhyh = mesh->getVertex(xhigh,yhigh);
+	///-------------------------------------------------------------------------------------------------
+	/// @fn	void Terrain::getHeights(const float *x, const float *z, float *heights, int count)
+	///
+	/// @brief	Calculates the interpolated terrain height below a batch of points.
+	///
+	/// @param	x		  	The world x coordinates.
+	/// @param	z		  	The world z coordinates.
+	/// @param	heights		Receives the interpolated heights.
+	/// @param	count	  	Number of points.
+
+	void Terrain::getHeights(const float *x, const float *z, float *heights, int count){
+		if (density == 0) {
+			for (int i=0; i<count; i++) heights[i] = 0;
+			return;
+		}
 
-		Vector3 xli = Vector3::lerp(xlyl,xlyh,yPos-ylow);
-		Vector3 xhi = Vector3::lerp(xhyl,xhyh,yPos-ylow);
+		Matrix4x4 world = gameObject->getTransform()->getWorldMatrix();
+		Vector3 terrainPos = world.getTrans();
+		float offsetX = size/2.0f - terrainPos.x;
+		float offsetZ = size/2.0f - terrainPos.z;
+		float invGrid = 1.0f/gridSize;
+
+		// world y of the surface point, whose local x and z are xPos*gridSize - size/2 and
+		// yPos*gridSize - size/2, folded into one multiply-add per term
+		float rowX = world[1][0]*gridSize;
+		float rowH = world[1][1];
+		float rowZ = world[1][2]*gridSize;
+		float rowW = world[1][3] - (world[1][0] + world[1][2])*size/2.0f;
+		float maxPos = (float)density;
+		int stride = density+1;
+		const float *h = &heightfield[0];
+		int i = 0;
+
+#ifdef T3D_SSE2
+		__m128 vOffsetX = _mm_set1_ps(offsetX);
+		__m128 vOffsetZ = _mm_set1_ps(offsetZ);
+		__m128 vInvGrid = _mm_set1_ps(invGrid);
+		__m128 vZero = _mm_setzero_ps();
+		__m128 vMax = _mm_set1_ps(maxPos);
+		__m128 vRowX = _mm_set1_ps(rowX);
+		__m128 vRowH = _mm_set1_ps(rowH);
+		__m128 vRowZ = _mm_set1_ps(rowZ);
+		__m128 vRowW = _mm_set1_ps(rowW);
+		__m128i vLast = _mm_set1_epi32(density);
+		__m128i vOne = _mm_set1_epi32(1);
+
+		for (; i+4 <= count; i += 4) {
+			__m128 xPos = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(x+i), vOffsetX), vInvGrid);
+			__m128 yPos = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(z+i), vOffsetZ), vInvGrid);
+			xPos = _mm_min_ps(_mm_max_ps(xPos, vZero), vMax);
+			yPos = _mm_min_ps(_mm_max_ps(yPos, vZero), vMax);
+
+			// positions are clamped to be positive, so truncation is floor
+			__m128i xlow = _mm_cvttps_epi32(xPos);
+			__m128i ylow = _mm_cvttps_epi32(yPos);
+			__m128 fx = _mm_sub_ps(xPos, _mm_cvtepi32_ps(xlow));
+			__m128 fy = _mm_sub_ps(yPos, _mm_cvtepi32_ps(ylow));
+
+			// the far edge has no next vertex, it reads the edge twice with a weight of 0
+			__m128i xstep = _mm_and_si128(_mm_cmplt_epi32(xlow, vLast), _mm_set1_epi32(stride));
+			__m128i ystep = _mm_and_si128(_mm_cmplt_epi32(ylow, vLast), vOne);
+
+			// SSE2 has no 32 bit multiply, the row offset is done with scalars
+			int xl[4], yl[4], xs[4], ys[4];
+			_mm_storeu_si128((__m128i*)xl, xlow);
+			_mm_storeu_si128((__m128i*)yl, ylow);
+			_mm_storeu_si128((__m128i*)xs, xstep);
+			_mm_storeu_si128((__m128i*)ys, ystep);
+
+			float c00[4], c01[4], c10[4], c11[4];
+			for (int k=0; k<4; k++) {
+				const float *cell = h + xl[k]*stride + yl[k];
+				c00[k] = cell[0];
+				c01[k] = cell[ys[k]];
+				c10[k] = cell[xs[k]];
+				c11[k] = cell[xs[k]+ys[k]];
+			}
 
-		Vector3 posOnTerrain = Vector3::lerp(xli,xhi,xPos-xlow);
+			__m128 v00 = _mm_loadu_ps(c00), v01 = _mm_loadu_ps(c01);
+			__m128 v10 = _mm_loadu_ps(c10), v11 = _mm_loadu_ps(c11);
+			__m128 xli = _mm_add_ps(v00, _mm_mul_ps(_mm_sub_ps(v01, v00), fy));
+			__m128 xhi = _mm_add_ps(v10, _mm_mul_ps(_mm_sub_ps(v11, v10), fy));
+			__m128 result = _mm_add_ps(xli, _mm_mul_ps(_mm_sub_ps(xhi, xli), fx));
+			result = _mm_add_ps(_mm_mul_ps(result, vRowH), _mm_mul_ps(xPos, vRowX));
+			result = _mm_add_ps(result, _mm_add_ps(_mm_mul_ps(yPos, vRowZ), vRowW));
+			_mm_storeu_ps(heights+i, result);
+		}
+#endif
+
+		for (; i<count; i++) {
+			float xPos = Math::clamp((x[i]+offsetX) * invGrid, 0, maxPos);
+			float yPos = Math::clamp((z[i]+offsetZ) * invGrid, 0, maxPos);
+
+			int xlow = int(xPos);
+			int ylow = int(yPos);
+			int xhigh = xlow < density ? xlow+1 : xlow;
+			int yhigh = ylow < density ? ylow+1 : ylow;
+			float fx = xPos-xlow;
+			float fy = yPos-ylow;
+
+			float xli = Math::lerp(h[xlow*stride+ylow], h[xlow*stride+yhigh], fy);
+			float xhi = Math::lerp(h[xhigh*stride+ylow], h[xhigh*stride+yhigh], fy);
+			heights[i] = rowX*xPos + rowH*Math::lerp(xli, xhi, fx) + rowZ*yPos + rowW;
+		}
+	}
 
-		return (gameObject->getTransform()->getWorldMatrix()*posOnTerrain).y;
+	// keeps a copy of the vertex heights for getHeights, which is faster than reading the mesh
+	void Terrain::storeHeights(PlaneMesh *mesh, int density){
+		this->density = density;
+		heightfield.resize((density+1)*(density+1));
+		for (int i=0; i<=density; i++){
+			for (int j=0; j<=density; j++){
+				heightfield[i*(density+1)+j] = mesh->getVertex(i,j).y;
+			}
+		}
 	}
 
 	///-------------------------------------------------------------------------------------------------
@@ -111,6 +213,7 @@ namespace T3D{
 			}
 
 			mesh->calcNormals();
+			storeHeights(mesh, density);
 
 			gameObject->setMesh(mesh);
 		}
@@ -144,6 +247,7 @@ namespace T3D{
 		}
 
 		mesh->calcNormals();
+		storeHeights(mesh, resolution);
 
 		gameObject->setMesh(mesh);
 
@@ -12,11 +12,14 @@
 #define TERRAIN_H
 
 #include <string>
+#include <vector>
 #include "component.h"
 #include "Vector3.h"
 
 namespace T3D{
 
+	class PlaneMesh;
+
 	//! A triangle mesh terrain class
 	/*! Can create a terrain from a texture or procudurally generate a fractal terrain
 	  \todo		Consider refactoring this class so that it is a subclass of Mesh
@@ -33,11 +36,30 @@ namespace T3D{
 
 		float getHeight(Vector3 pos);
 
+		/*! Terrain heights below a batch of world space points
+		  Reads the heightfield directly, four points at a time where SSE2 is available.
+		  Points are found on the grid by their offset from the terrain's position, and the
+		  surface point there is taken through the terrain's world matrix, so scale and tilt
+		  apply to the height.
+		  Only reads the terrain, so several threads may call it once its world matrix is current.
+		  \param x			world x of each point
+		  \param z			world z of each point
+		  \param heights	receives the world y of the surface below each point
+		  \param count		number of points
+		  */
+		void getHeights(const float *x, const float *z, float *heights, int count);
+
 		void createTerrain(std::string tex, float horizScale, float vertScale);
 		void createFractalTerrain(int resolution, float horizScale, float vertScale, float roughness);
 
 		float size;
 		float gridSize;
+
+	protected:
+		void storeHeights(PlaneMesh *mesh, int density);
+
+		int density;					// grid cells along each side
+		std::vector<float> heightfield;	// local vertex heights, (density+1)^2 in PlaneMesh order
 	};
 
 }
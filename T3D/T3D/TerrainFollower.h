@@ -24,6 +24,7 @@ namespace T3D{
 		virtual ~TerrainFollower(void);
 
 		virtual void update(float dt);
+		virtual UpdateAccess getUpdateAccess() const { return ACCESS_READ_TRANSFORMS; }		// reads the terrain
 
 	private:
 		Terrain* terrain;
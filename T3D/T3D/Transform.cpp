@@ -12,35 +12,76 @@
 #include <queue>
 #include "Transform.h"
 #include "GameObject.h"
+#include "JobSystem.h"
 
 namespace T3D
 {
+	unsigned int Transform::deletions = 0;
+	std::vector<Transform*> *Transform::deferredBounds = NULL;
+	std::vector<Transform*> *Transform::staleWorlds = NULL;
+
 	Transform::Transform(Transform* p, std::string n)
 	{
 		name = n;
 
+		hierarchy = NULL;
+		hierarchyIndex = -1;
+
 		parent = NULL;
 		setParent(p);
 
 		localMatrix = Matrix4x4::IDENTITY;
 
 		if (p!=NULL){
-			worldMatrix = p->worldMatrix;
+			worldMatrix = p->getWorldStorage();
 		} else { 
 			worldMatrix = Matrix4x4::IDENTITY;
 		}
 
-		translationMatrix = Matrix4x4::IDENTITY;
-		scaleMatrix = Matrix3x3::IDENTITY;
-		rotationMatrix = Matrix3x3::IDENTITY;
+		localPosition = Vector3(0,0,0);
+		localRotation = Quaternion();
+		localScale = Vector3(1,1,1);
 		needLocalUpdate = false;
 		needWorldUpdate = false;
 		mNeedBoundUpdate = true;
 	} 
 
+	// Copies never share a slot in the original's TransformHierarchy
+	Transform::Transform(const Transform& t) : Component(t)
+	{
+		hierarchy = NULL;
+		hierarchyIndex = -1;
+		*this = t;
+	}
+
+	Transform& Transform::operator=(const Transform& t)
+	{
+		if (this != &t)
+		{
+			gameObject = t.gameObject;
+			Transform &src = const_cast<Transform&>(t);
+			getLocalStorage() = src.getLocalStorage();
+			getWorldStorage() = src.getWorldStorage();
+			needLocalUpdate = t.needLocalUpdate;
+			needWorldUpdate = t.needWorldUpdate;
+			localPosition = t.localPosition;
+			localRotation = t.localRotation;
+			localScale = t.localScale;
+			parent = t.parent;
+			name = t.name;
+			children = t.children;
+			mBoundingSphere = t.mBoundingSphere;
+			mNeedBoundUpdate = t.mNeedBoundUpdate;
+			if (hierarchy)
+				hierarchy->dirty[hierarchyIndex] = needWorldUpdate ? 1 : 0;
+		}
+		return *this;
+	}
+
 
 	Transform::~Transform(void)
 	{
+		deletions++;
 		for(unsigned int i = 0; i < children.size(); ++i)
 		{
 			if(NULL != children[i])
@@ -53,6 +94,10 @@ namespace T3D
 			parent = NULL;
 		}
 		children.clear();
+		if (hierarchy != NULL) {
+			hierarchy->remove(hierarchyIndex);
+			hierarchy = NULL;
+		}
 		delete gameObject;
 	}
 
@@ -62,7 +107,7 @@ namespace T3D
 		if (needLocalUpdate){
 			calcLocalMatrix();
 		}
-		return localMatrix;
+		return getLocalStorage();
 	}
 
 	Matrix4x4 Transform::getWorldMatrix()
@@ -70,7 +115,7 @@ namespace T3D
 		if (needWorldUpdate){
 			update(false);
 		}
-		return worldMatrix;
+		return getWorldStorage();
 	}
 
 	void Transform::update(bool updateChildren)
@@ -84,12 +129,15 @@ namespace T3D
 			if (parent->needWorldUpdate){
 				parent->update(false);
 			}
-			worldMatrix = parent->worldMatrix*localMatrix;
+			getWorldStorage() = parent->getWorldStorage()*getLocalStorage();
 		} else {
-			worldMatrix = localMatrix;
+			getWorldStorage() = getLocalStorage();
 		}
 
 		needWorldUpdate = false;
+		if (hierarchy){
+			hierarchy->dirty[hierarchyIndex] = 0;
+		}
 
 		if(updateChildren && !children.empty())
 		{
@@ -103,18 +151,45 @@ namespace T3D
 		}
 	} 
 
+	// Like update(true) but only recomputes the world matrices that are out of date
+	void Transform::refreshWorldMatrices()
+	{
+		if (needWorldUpdate){
+			update(false);
+		}
+		for(unsigned int i = 0; i < children.size(); ++i)
+		{
+			if(NULL != children[i])
+			{
+				children[i]->refreshWorldMatrices();
+			}
+		}
+	}
+
 	void Transform::calcLocalMatrix(){
-		Matrix4x4 scaleRotate = Matrix4x4::IDENTITY;
-		scaleRotate = (rotationMatrix*scaleMatrix);
-		localMatrix = translationMatrix*scaleRotate;
+		getLocalStorage().makeTransform(localPosition, localScale, localRotation);
 		setNeedBoundUpdate();
 		needLocalUpdate = false;
 	}
 
+	// the parent's bound is marked now rather than when the matrix is next calculated, which
+	// with lazy world matrices can be after the renderer has culled against the old bound
+	void Transform::setNeedLocalUpdate(){
+		needLocalUpdate = true;
+		setNeedBoundUpdate();
+		setNeedWorldUpdate();
+	}
+
 	void Transform::setNeedWorldUpdate(){
 		if (!needWorldUpdate)
 		{
+			if (staleWorlds != NULL && (parent == NULL || !parent->needWorldUpdate)){
+				staleWorlds[JobSystem::getCurrentWorker()].push_back(this);
+			}
 			needWorldUpdate = true;
+			if (hierarchy){
+				hierarchy->dirty[hierarchyIndex] = 1;
+			}
 			if(!children.empty())
 			{
 				for(unsigned int i = 0; i < children.size(); ++i)
@@ -130,9 +205,8 @@ namespace T3D
 
 
 	void Transform::setLocalPosition(const Vector3& pos){
-		translationMatrix.setTrans(pos);
-		needLocalUpdate = true;
-		setNeedWorldUpdate();
+		localPosition = pos;
+		setNeedLocalUpdate();
 	}		
 	void Transform::setWorldPosition(const Vector3& pos){
 		if (needWorldUpdate){
@@ -141,54 +215,64 @@ namespace T3D
 		if (parent)
 			setLocalPosition(pos - parent->getWorldPosition());
 	}
+	// same yaw * pitch * roll ordering as Matrix3x3::fromEulerAngles
 	void Transform::setLocalRotation(const Vector3& rot){
-		rotationMatrix.fromEulerAngles(rot.y,rot.x,rot.z);
-		needLocalUpdate = true;
-		setNeedWorldUpdate();
+		localRotation = Quaternion::fromAngleAxis(rot.y,Vector3(0,1,0)) *
+						Quaternion::fromAngleAxis(rot.x,Vector3(1,0,0)) *
+						Quaternion::fromAngleAxis(rot.z,Vector3(0,0,1));
+		setNeedLocalUpdate();
 	}
 	void Transform::setLocalRotation(Quaternion& q){
-		rotationMatrix = (Matrix3x3)q;
-		needLocalUpdate = true;
-		setNeedWorldUpdate();
+		localRotation = q;
+		if (fabs(localRotation.squaredLength()-1.0f)>0.0001f){
+			localRotation.normalise();
+		}
+		setNeedLocalUpdate();
+	}
+	void Transform::setLocalPositionRotation(const Vector3& pos, const Quaternion& q){
+		localPosition = pos;
+		localRotation = q;
+		if (fabs(localRotation.squaredLength()-1.0f)>0.0001f){
+			localRotation.normalise();
+		}
+		setNeedLocalUpdate();
 	}
 	void Transform::setLocalScale(const Vector3& scl){
-		scaleMatrix[0][0] = scl.x;
-		scaleMatrix[1][1] = scl.y;
-		scaleMatrix[2][2] = scl.z;
-		needLocalUpdate = true;
-		setNeedWorldUpdate();
+		localScale = scl;
+		setNeedLocalUpdate();
 	}
 		
 	const Vector3 Transform::getLocalPosition(){
-		return translationMatrix.getTrans();
+		return localPosition;
 	}
 		
 	const Vector3 Transform::getWorldPosition(){
 		if (needWorldUpdate){
 			update(false);
 		}
-		return worldMatrix.getTrans();
+		return getWorldStorage().getTrans();
 	}
 
 	const Vector3 Transform::getEulerAngles(){
 		Vector3 v;
-		rotationMatrix.toEulerAngles(v.y,v.x,v.z);
+		getRotationMatrix().toEulerAngles(v.y,v.x,v.z);
 		return v;
 	}
 	const Quaternion Transform::getQuaternion(){
-		return Quaternion(rotationMatrix);
+		return localRotation;
+	}
+	const Matrix3x3 Transform::getRotationMatrix(){
+		Quaternion q = localRotation;
+		return (Matrix3x3)q;
 	}
 	const Vector3 Transform::getLocalScale(){
-		return Vector3(scaleMatrix[0][0],scaleMatrix[1][1],scaleMatrix[2][2]);
+		return localScale;
 	}
 
 	void Transform::move(const Vector3& delta){
-		translationMatrix[0][3] += delta.x;
-		translationMatrix[1][3] += delta.y;
-		translationMatrix[2][3] += delta.z;
+		localPosition += delta;
 
-		needLocalUpdate = true;
-		setNeedWorldUpdate();
+		setNeedLocalUpdate();
 	}
 
 	void Transform::roll(const float angle)
@@ -223,10 +307,10 @@ namespace T3D
     //-----------------------------------------------------------------------
     void Transform::rotate(Quaternion& q)
     {
-        rotationMatrix = rotationMatrix * (Matrix3x3)q;
+        localRotation = localRotation * q;
+		localRotation.normalise();			// stops drift from repeated small rotations
 
-		needLocalUpdate = true;
-		setNeedWorldUpdate();
+		setNeedLocalUpdate();
     }
 
 	// Make -ve z axis point at other
@@ -238,10 +322,11 @@ namespace T3D
 			Vector3 zaxis = -vectorTo.normalised();
 			Vector3 xaxis = -zaxis.cross(up).normalised();
 			Vector3 yaxis = zaxis.cross(xaxis);
+			Matrix3x3 rotationMatrix;
 			rotationMatrix.FromAxes(xaxis,yaxis,zaxis);
+			localRotation = Quaternion(rotationMatrix);
 		}
-		needLocalUpdate = true;
-		setNeedWorldUpdate();
+		setNeedLocalUpdate();
 	}
 
 	Vector3 Transform::transformPoint(Vector3 &p){
@@ -267,6 +352,13 @@ namespace T3D
 				p->addChild(this);
 			}
 			parent = p;
+
+			// a flattened hierarchy on either side needs re-sorting
+			if (hierarchy != NULL)
+				hierarchy->setNeedRebuild();
+			if (p != NULL && p->hierarchy != NULL)
+				p->hierarchy->setNeedRebuild();
+
 			setNeedWorldUpdate();
 		}
 	}
@@ -317,7 +409,6 @@ namespace T3D
 		Transform* current = this;
 
 		while (current!=NULL && n.compare(current->name) != 0){
-			std::cout << "processing " << current->name << "\n";
 			if(!current->children.empty())
 			{
 				for(unsigned int i = 0; i < current->children.size(); ++i)
@@ -346,7 +437,9 @@ namespace T3D
 		}
 
 		for (auto child : children) {
-			mBoundingSphere = mBoundingSphere.growToContain(child->getLocalMatrix() * child->getBoundingSphere());
+			// fetch the local matrix first, recalculating it marks the child's bound as needing an update
+			Matrix4x4 local = child->getLocalMatrix();
+			mBoundingSphere = mBoundingSphere.growToContain(local * child->getBoundingSphere());
 		}
 
 		mNeedBoundUpdate = false;
@@ -374,12 +467,33 @@ namespace T3D
 		//ancestor with mNeedBoundUpdate = true already,
 		//because of the invariant.
 
+		//while deferred the invariant is restored by propagateBoundUpdates,
+		//a transform already marked needs nothing recorded as its ancestors are too
+		if (deferredBounds != NULL) {
+			if (!mNeedBoundUpdate) {
+				mNeedBoundUpdate = true;
+				deferredBounds[JobSystem::getCurrentWorker()].push_back(this);
+			}
+			return;
+		}
+
 		Transform* t = this;
 		while (t && !t->mNeedBoundUpdate) {
 			t->mNeedBoundUpdate = true;
 			t = t->parent;
 		}
 	}
+
+	void Transform::propagateBoundUpdates(std::vector<Transform*> &marked) {
+		for (unsigned int i = 0; i < marked.size(); ++i) {
+			Transform* t = marked[i]->parent;
+			while (t && !t->mNeedBoundUpdate) {
+				t->mNeedBoundUpdate = true;
+				t = t->parent;
+			}
+		}
+		marked.clear();
+	}
 }
 
 
@@ -20,6 +20,7 @@
 #include "Component.h"
 #include "Quaternion.h"
 #include "BoundingSphere.h"
+#include "TransformHierarchy.h"
 
 /*
 	The Transform class is horrible and is the root
@@ -44,9 +45,13 @@ namespace T3D
 	{
 	public:
 		Transform(Transform* parent = NULL, std::string name = "noname");
+		Transform(const Transform& t);
 		~Transform(void);
+
+		Transform& operator=(const Transform& t);
  
 		virtual void update(bool updateChildren = true);
+		void refreshWorldMatrices();
  
 		Transform* getParent(void) const;
 		void setParent(Transform* p);
@@ -65,6 +70,8 @@ namespace T3D
 		void setWorldPosition(const Vector3& pos);
 		void setLocalRotation(const Vector3& rot);
 		void setLocalRotation(Quaternion& q);
+		//! Sets both with a single world update, for animation
+		void setLocalPositionRotation(const Vector3& pos, const Quaternion& q);
 		void setLocalScale(const Vector3& scl);
 
 		void move(const Vector3& delta);void Transform::roll(const float angle);
@@ -82,7 +89,7 @@ namespace T3D
 		const Vector3 getLocalPosition();
 		const Vector3 getEulerAngles();
 		const Quaternion getQuaternion();
-		const Matrix3x3 getRotationMatrix(){ return rotationMatrix; }
+		const Matrix3x3 getRotationMatrix();
 		const Vector3 getLocalScale();
 		
 		const Vector3 getWorldPosition();
@@ -98,33 +105,62 @@ namespace T3D
         }
 
 	private:
+		friend class TransformHierarchy;
+
 		void calcLocalMatrix();
+		void setNeedLocalUpdate();
 		void setNeedWorldUpdate();
 
+		// while attached to a TransformHierarchy the matrices live in its arrays,
+		// otherwise in localMatrix/worldMatrix below
+		Matrix4x4& getLocalStorage(){ return hierarchy ? hierarchy->localMatrices[hierarchyIndex] : localMatrix; }
+		Matrix4x4& getWorldStorage(){ return hierarchy ? hierarchy->worldMatrices[hierarchyIndex] : worldMatrix; }
+
 		Matrix4x4 localMatrix;
 		Matrix4x4 worldMatrix;
+		TransformHierarchy* hierarchy;
+		int hierarchyIndex;
 		bool needLocalUpdate;
 		bool needWorldUpdate;
 		
-		Matrix4x4 translationMatrix;
-		Matrix3x3 rotationMatrix;
-		Matrix3x3 scaleMatrix;
+		// local transform stored as translation, rotation, scale
+		Vector3 localPosition;
+		Quaternion localRotation;
+		Vector3 localScale;
 
 	public:
 		Transform* parent;
 		std::string name;
 		std::vector<Transform*> children;
 
+		static unsigned int deletions;		// count of transforms deleted, lets caches spot stale pointers
+
 	//to support  hierarchical bounding volume (HBV) culling
 
 		BoundingSphere getBoundingSphere();
+		void setNeedBoundUpdate();			// call when the game object's bounding sphere changes
+
+		/*! Marks the ancestors of transforms whose bound changed while updates were deferred
+		  Each walk stops at the first ancestor already marked, as setNeedBoundUpdate's does.
+		  \param marked	transforms recorded by setNeedBoundUpdate, emptied
+		  */
+		static void propagateBoundUpdates(std::vector<Transform*> &marked);
+
+		// one list per job worker, NULL unless deferring.  While set setNeedBoundUpdate only marks
+		// the transform itself and records it in the calling worker's list, so that components
+		// updating on several threads never write to a shared ancestor
+		static std::vector<Transform*> *deferredBounds;
+
+		// one list per job worker, NULL unless recording.  While set a transform whose world matrix
+		// goes out of date under a current parent is recorded in the calling worker's list, so
+		// the subtrees that need refreshing can be found without walking the whole scene
+		static std::vector<Transform*> *staleWorlds;
 
 	private:
 		BoundingSphere mBoundingSphere;
 		
 		bool mNeedBoundUpdate;
 		void updateBound();
-		void setNeedBoundUpdate();
 
 	}; 
 }
@@ -0,0 +1,139 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// transformhierarchy.cpp
+//
+// Optional flattened storage for the matrices of a scene graph.
+// Every transform below the root is given a slot in contiguous local/world matrix arrays,
+// ordered so that a parent always comes before its children.  This lets all dirty world
+// matrices be brought up to date in one linear pass rather than a recursive walk.
+
+#include "TransformHierarchy.h"
+#include "Transform.h"
+
+namespace T3D
+{
+	TransformHierarchy::TransformHierarchy(Transform* root) : root(root)
+	{
+		needRebuild = true;
+		rebuild();
+	}
+
+	TransformHierarchy::~TransformHierarchy(void)
+	{
+		// hand the matrices back to any transforms that are still alive
+		for (unsigned int i = 0; i < nodes.size(); ++i)
+		{
+			Transform *t = nodes[i];
+			if (t != NULL)
+			{
+				t->localMatrix = localMatrices[i];
+				t->worldMatrix = worldMatrices[i];
+				t->hierarchy = NULL;
+				t->hierarchyIndex = -1;
+			}
+		}
+	}
+
+	void TransformHierarchy::remove(int index)
+	{
+		nodes[index] = NULL;
+		dirty[index] = 0;
+		needRebuild = true;
+	}
+
+	void TransformHierarchy::rebuild()
+	{
+		std::vector<Transform*> newNodes;
+		std::vector<int> newParents;
+		std::vector<Matrix4x4> newLocal;
+		std::vector<Matrix4x4> newWorld;
+		std::vector<unsigned char> newDirty;
+
+		newNodes.reserve(nodes.size());
+		newParents.reserve(nodes.size());
+		newLocal.reserve(nodes.size());
+		newWorld.reserve(nodes.size());
+		newDirty.reserve(nodes.size());
+
+		// depth first pre-order keeps every subtree in a contiguous run
+		std::vector<std::pair<Transform*, int> > stack;
+		if (root != NULL)
+			stack.push_back(std::make_pair(root, -1));
+
+		while (!stack.empty())
+		{
+			Transform *t = stack.back().first;
+			int parentIndex = stack.back().second;
+			stack.pop_back();
+
+			int index = (int)newNodes.size();
+			newNodes.push_back(t);
+			newParents.push_back(parentIndex);
+			newLocal.push_back(t->getLocalStorage());			// still reads from the old slot
+			newWorld.push_back(t->getWorldStorage());
+			newDirty.push_back(t->needWorldUpdate ? 1 : 0);
+
+			for (int i = (int)t->children.size() - 1; i >= 0; --i)
+			{
+				if (t->children[i] != NULL)
+					stack.push_back(std::make_pair(t->children[i], index));
+			}
+		}
+
+		// transforms that are no longer below the root keep their own copy of their matrices
+		for (unsigned int i = 0; i < nodes.size(); ++i)
+		{
+			Transform *t = nodes[i];
+			if (t != NULL)
+			{
+				t->localMatrix = localMatrices[i];
+				t->worldMatrix = worldMatrices[i];
+				t->hierarchy = NULL;
+				t->hierarchyIndex = -1;
+			}
+		}
+
+		for (unsigned int i = 0; i < newNodes.size(); ++i)
+		{
+			newNodes[i]->hierarchy = this;
+			newNodes[i]->hierarchyIndex = i;
+		}
+
+		nodes.swap(newNodes);
+		parents.swap(newParents);
+		localMatrices.swap(newLocal);
+		worldMatrices.swap(newWorld);
+		dirty.swap(newDirty);
+
+		needRebuild = false;
+	}
+
+	void TransformHierarchy::update()
+	{
+		if (needRebuild)
+			rebuild();
+
+		int count = (int)nodes.size();
+		for (int i = 0; i < count; ++i)
+		{
+			if (!dirty[i]) continue;
+
+			Transform *t = nodes[i];
+			if (t->needLocalUpdate)
+				t->calcLocalMatrix();
+
+			int p = parents[i];
+			if (p >= 0)
+				worldMatrices[i] = worldMatrices[p] * localMatrices[i];
+			else if (t->parent != NULL)
+				worldMatrices[i] = t->parent->getWorldMatrix() * localMatrices[i];
+			else
+				worldMatrices[i] = localMatrices[i];
+
+			t->needWorldUpdate = false;
+			dirty[i] = 0;
+		}
+	}
+}
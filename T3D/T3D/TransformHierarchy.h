@@ -0,0 +1,61 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// transformhierarchy.h
+//
+// Optional flattened storage for the matrices of a scene graph.
+// Every transform below the root is given a slot in contiguous local/world matrix arrays,
+// ordered so that a parent always comes before its children.  This lets all dirty world
+// matrices be brought up to date in one linear pass rather than a recursive walk.
+
+#ifndef TRANSFORMHIERARCHY_H
+#define TRANSFORMHIERARCHY_H
+
+#include <vector>
+#include "Matrix4x4.h"
+
+namespace T3D
+{
+	class Transform;
+
+	class TransformHierarchy
+	{
+	public:
+		TransformHierarchy(Transform* root);
+		virtual ~TransformHierarchy(void);
+
+		/*! Recomputes every dirty world matrix in a single pass over the arrays
+		  Rebuilds the ordering first if the structure of the tree has changed
+		  */
+		void update();
+
+		/*! Re-sorts the arrays parent-before-child
+		  Transforms that have been added below the root are adopted, transforms that
+		  have left it go back to storing their own matrices
+		  */
+		void rebuild();
+
+		void setNeedRebuild(){ needRebuild = true; }
+
+		int size() const { return (int)nodes.size(); }
+		Transform* getRoot() const { return root; }
+
+	private:
+		friend class Transform;
+
+		void remove(int index);
+
+		Transform* root;
+		bool needRebuild;
+
+		std::vector<Transform*> nodes;				// NULL once a transform has been deleted
+		std::vector<int> parents;					// index of parent slot, -1 for the root
+		std::vector<Matrix4x4> localMatrices;
+		std::vector<Matrix4x4> worldMatrices;
+		std::vector<unsigned char> dirty;			// mirrors Transform::needWorldUpdate
+	};
+}
+
+#endif
+
@@ -0,0 +1,102 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// transforminterpolator.cpp
+//
+// Blends the scene graph between the last two fixed simulation steps for rendering
+// capture() records every local transform before a step, apply() moves each transform that
+// changed part way back towards its recorded state, and restore() undoes that after drawing.
+
+#include "TransformInterpolator.h"
+#include "Transform.h"
+
+namespace T3D
+{
+	TransformInterpolator::TransformInterpolator(void)
+	{
+		deletions = 0;
+		captured = false;
+	}
+
+	TransformInterpolator::~TransformInterpolator(void)
+	{
+	}
+
+	void TransformInterpolator::capture(Transform *root)
+	{
+		previous.clear();
+		deletions = Transform::deletions;
+		captured = true;
+
+		std::vector<Transform*> stack;
+		if (root) stack.push_back(root);
+
+		while (!stack.empty())
+		{
+			Transform *t = stack.back();
+			stack.pop_back();
+
+			Snapshot s;
+			s.transform = t;
+			s.position = t->getLocalPosition();
+			s.rotation = t->getQuaternion();
+			s.scale = t->getLocalScale();
+			previous.push_back(s);
+
+			for (unsigned int i = 0; i < t->children.size(); ++i)
+			{
+				if (t->children[i] != NULL)
+					stack.push_back(t->children[i]);
+			}
+		}
+	}
+
+	void TransformInterpolator::apply(float alpha)
+	{
+		current.clear();
+
+		// a snapshot may point at a deleted transform, just draw the current state this frame
+		if (!captured || deletions != Transform::deletions)
+			return;
+
+		for (unsigned int i = 0; i < previous.size(); ++i)
+		{
+			Snapshot &p = previous[i];
+			Snapshot c;
+			c.transform = p.transform;
+			c.position = p.transform->getLocalPosition();
+			c.rotation = p.transform->getQuaternion();
+			c.scale = p.transform->getLocalScale();
+
+			bool rotated = c.rotation.s != p.rotation.s || !(c.rotation.v == p.rotation.v);
+			if (c.position == p.position && !rotated && c.scale == p.scale)
+				continue;					// didn't move, nothing to blend
+
+			current.push_back(c);
+
+			p.transform->setLocalPosition(p.position + (c.position - p.position) * alpha);
+			p.transform->setLocalScale(p.scale + (c.scale - p.scale) * alpha);
+			if (rotated)
+			{
+				// take the short way round
+				Quaternion to = c.rotation;
+				if (Quaternion::dot(p.rotation, to) < 0) to = -to;
+				Quaternion q = Quaternion::lerp(p.rotation, to, alpha);
+				p.transform->setLocalRotation(q);
+			}
+		}
+	}
+
+	void TransformInterpolator::restore()
+	{
+		for (unsigned int i = 0; i < current.size(); ++i)
+		{
+			Snapshot &c = current[i];
+			c.transform->setLocalPosition(c.position);
+			c.transform->setLocalRotation(c.rotation);
+			c.transform->setLocalScale(c.scale);
+		}
+		current.clear();
+	}
+}
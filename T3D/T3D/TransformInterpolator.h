@@ -0,0 +1,56 @@
+// =========================================================================================
+// KXG363 - Advanced Games Programming, 2026
+// =========================================================================================
+//
+// transforminterpolator.h
+//
+// Blends the scene graph between the last two fixed simulation steps for rendering
+// capture() records every local transform before a step, apply() moves each transform that
+// changed part way back towards its recorded state, and restore() undoes that after drawing.
+
+#ifndef TRANSFORMINTERPOLATOR_H
+#define TRANSFORMINTERPOLATOR_H
+
+#include <vector>
+#include "Vector3.h"
+#include "Quaternion.h"
+
+namespace T3D
+{
+	class Transform;
+
+	class TransformInterpolator
+	{
+	public:
+		TransformInterpolator(void);
+		virtual ~TransformInterpolator(void);
+
+		//! Records the local state of every transform below root
+		void capture(Transform *root);
+
+		/*! Sets each transform that has moved since capture to a blend of the two states
+		  \param alpha		0 gives the captured state, 1 the current state
+		  */
+		void apply(float alpha);
+
+		//! Puts back the states replaced by apply
+		void restore();
+
+	private:
+		struct Snapshot
+		{
+			Transform *transform;
+			Vector3 position;
+			Quaternion rotation;
+			Vector3 scale;
+		};
+
+		std::vector<Snapshot> previous;		// from capture
+		std::vector<Snapshot> current;		// replaced by apply
+		unsigned int deletions;				// Transform::deletions at capture
+		bool captured;
+	};
+}
+
+#endif
+
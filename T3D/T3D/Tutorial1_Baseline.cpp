@@ -2,7 +2,6 @@
 #include "PerfLogTask.h"
 #include "DiagMessageTask.h"
 #include "Camera.h"
-#include "Sphere.h"
 #include "KeyboardController.h"
 #include "Math.h"
 
@@ -55,18 +54,8 @@ namespace T3D {
 		const double box_size = 5;
 		const double sphere_density = 32;
 		const char* sphere_name = "Sphere";
-		//wasted memory:
-		//the GameObject destructor deletes the mesh object,
-		//i.e it assumes ownership.
-		//this means, even though the sphere is identical and immutable
-		//it can not be reused in multiple GameObjects.
-		//solution:
-		//remove Mesh ownership from the sphere GameObject,
-		//mave an object with a greater lifetime manage the Mesh memory.
-		//OR
-		//use a c++ sharedpointer
-		//OR
-		//Use some other reference-counted design that involves a bigger refactor?
+		//the spheres are identical, so they all share one mesh from the cache.
+		//meshes are reference counted, the last GameObject using it frees it.
 		
 		for (int i = 0; i < 100; i++) {
 
@@ -78,9 +67,9 @@ namespace T3D {
 
 			//create sphere object
 			GameObject *sphere = new GameObject(this);
-			sphere->setMesh(new Sphere(0.5, sphere_density));
+			sphere->setMesh(meshCache->getSphere(0.5, sphere_density));
 			
-			sphere->setMaterial(red); //thankfully the renderer owns the material. (Why isn't this the case for Meshes?)
+			sphere->setMaterial(red); //the renderer owns the material
 			sphere->getTransform()->setLocalPosition(point);
 			sphere->getTransform()->setParent(root);
 			sphere->getTransform()->name = sphere_name;
@@ -105,28 +105,21 @@ namespace T3D
 		running = true;
 
 		SDL_Event sdlEvent;
-		lastFrame = SDL_GetTicks()/1000.0f;
+		clock.reset();
 		while(running) {
 			soundManager->update();
+			jobSystem->resetScratch();
 
-			float thisFrame = SDL_GetTicks()/1000.0f;
-			dt = thisFrame-lastFrame;
-			lastFrame = thisFrame;
+			double frameTime = clock.tick();
 			
 			Input::onMouseMotion(0,0);
 			while(SDL_PollEvent(&sdlEvent)) {
 				handleEvent(&sdlEvent);
 			}
 
+			advance(frameTime);
 
-			updateTasks();
-
-			updateComponents(root);
-
-			renderer->prerender();
-			renderer->render(root);
-
-			renderer->postrender();
+			renderFrame();
 		}
 
 		quit();